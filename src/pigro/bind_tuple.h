@@ -39,11 +39,11 @@ auto bind_back_tuple(auto &&f, concepts::tuple_like auto &&t) {
           compressed_tuple_element<0>(FWD(f)),
           compressed_tuple_element<1>(FWD(t)),
           [](auto &&self, auto &&...args)
-            -> decltype(pigro::apply(std::bind_front(f, FWD(args)...), t)) {
+            -> decltype(pigro::apply(std::bind_front(std::ref(f), FWD(args)...), t)) {
               auto &&f = self(idx<0>);
               auto &&t = self(idx<1>);
 
-              return pigro::apply(std::bind_front(f, FWD(args)...), t);
+              return pigro::apply(std::bind_front(std::ref(f), FWD(args)...), t);
           },
         }
     };
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "lazy.h"
+#include "regular_void.h"
+#include "tuple_algorithms.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pigro {
+
+class cache_budget;
+
+// Approximates the memory held by a cached value. Contiguous ranges (strings,
+// vectors, ...) also count their elements.
+constexpr auto cached_bytes = [](const auto &value) -> std::size_t {
+    using value_t = std::remove_cvref_t<decltype(value)>;
+
+    if constexpr (std::ranges::contiguous_range<const value_t> && std::ranges::sized_range<const value_t>) {
+        return sizeof(value_t) + std::ranges::size(value) * sizeof(std::ranges::range_value_t<const value_t>);
+    } else {
+        return sizeof(value_t);
+    }
+};
+
+} // namespace pigro
+
+namespace pigro::detail {
+
+class budget_entry {
+    friend cache_budget;
+
+    cache_budget *budget;
+    std::list<budget_entry *>::iterator position;
+    bool registered = false;
+    std::size_t bytes = 0;
+    std::size_t cycle = 0;
+
+protected:
+    explicit budget_entry(cache_budget &budget) : budget{ &budget } {}
+    ~budget_entry();
+
+    budget_entry(const budget_entry &) = delete;
+    budget_entry &operator=(const budget_entry &) = delete;
+
+    void charge(std::size_t bytes);
+
+public:
+    virtual void release() = 0;
+};
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Tracks the bytes cached by its lazy functions. Whenever they exceed the
+// limit, the least recently pulled ones release their cached values, but
+// keep the versions of their dependencies. Such a node recomputes its value
+// on the next pull, without reporting a change if the dependencies are still
+// the same. Nodes that were pulled during the current pull cycle are never
+// released, because dependents may still refer to their values.
+class cache_budget {
+    friend detail::budget_entry;
+
+    std::size_t limit_;
+    std::size_t used_ = 0;
+    std::size_t evictions_ = 0;
+    std::list<detail::budget_entry *> entries; // From cold to hot
+
+    void forget(detail::budget_entry &entry) {
+        if (!entry.registered) return;
+
+        used_ -= entry.bytes;
+        entries.erase(entry.position);
+        entry.registered = false;
+        entry.bytes = 0;
+    }
+
+    void charge(detail::budget_entry &entry, std::size_t bytes) {
+        forget(entry);
+
+        entry.position = entries.insert(entries.end(), &entry);
+        entry.registered = true;
+        entry.bytes = bytes;
+        entry.cycle = detail::pull_cycle::current;
+        used_ += bytes;
+
+        trim();
+    }
+
+public:
+    explicit cache_budget(std::size_t limit) : limit_{ limit } {}
+
+    cache_budget(const cache_budget &) = delete;
+    cache_budget &operator=(const cache_budget &) = delete;
+
+    auto limit() const { return limit_; }
+    auto used() const { return used_; }
+    auto evictions() const { return evictions_; }
+
+    // Releases the coldest values until the cached bytes fit within the limit.
+    void trim() {
+        const auto is_hot = [](const detail::budget_entry *entry) {
+            return detail::pull_cycle::is_active() && entry->cycle == detail::pull_cycle::current;
+        };
+
+        for (auto it = entries.begin(); used_ > limit_ && it != entries.end();) {
+            auto &entry = **it++;
+            if (is_hot(&entry)) break;
+
+            forget(entry);
+            entry.release();
+            ++evictions_;
+        }
+    }
+};
+
+} // namespace pigro
+
+namespace pigro::detail {
+
+inline budget_entry::~budget_entry() { budget->forget(*this); }
+
+inline void budget_entry::charge(std::size_t bytes) { budget->charge(*this, bytes); }
+
+template<typename F, typename... Deps>
+struct budgeted_node : budget_entry {
+    using value_t = decltype(std::declval<F &>()(std::declval<Deps &>()(nullptr).value...));
+    using versions_t = std::tuple<decltype(std::declval<Deps &>()(nullptr).version)...>;
+
+    F f;
+    std::tuple<Deps...> deps;
+
+    versions_t seen = {};
+    bool computed = false;
+    versioned_cache<value_t> cache;
+
+    budgeted_node(cache_budget &budget, F f, Deps... deps)
+      : budget_entry{ budget }, f{ std::move(f) }, deps{ std::move(deps)... } {}
+
+    // Void functions have nothing to release, and their version is implied by
+    // the cache itself.
+    void release() override {
+        if constexpr (!std::is_same_v<value_t, regular_void>) cache.value.reset();
+    }
+
+    auto pull() {
+        const auto args = std::apply([](auto &...deps) { return std::tuple{ deps(nullptr)... }; }, deps);
+        const auto versions = transform(args, version);
+        const auto make = [&] { return std::apply(f, transform_ref(args, value)); };
+
+        auto changed = false;
+        if (!computed || versions != seen) {
+            // A released value can't be compared anymore, so it is considered changed
+            changed = cache.update(make);
+            seen = versions;
+            computed = true;
+        } else if constexpr (!std::is_same_v<value_t, regular_void>) {
+            if (!cache) cache.value.emplace(materialize<decltype(make)>{ make });
+        }
+
+        if constexpr (!std::is_same_v<value_t, regular_void>) charge(cached_bytes(*cache));
+
+        return changed;
+    }
+};
+
+auto budgeted_core(cache_budget &budget, auto f, concepts::lazy_function auto... deps) {
+    using node_t = budgeted_node<decltype(f), decltype(deps)...>;
+
+    auto node = std::make_shared<node_t>(budget, std::move(f), std::move(deps)...);
+    return compressed_tuple{ node } << [](std::nullptr_t, auto &&node) {
+        const auto changed = node->pull();
+
+        return LazyResult{
+            *node->cache,
+            changed,
+            node->cache.version(),
+        };
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Registers the cached value with the budget, which may release it whenever
+// other lazy functions need the memory. All copies refer to the same node.
+auto lazy(cache_budget &budget, auto f, auto... deps) {
+    auto lazy_f = detail::budgeted_core(
+      budget,
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+} // namespace pigro
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace pigro {
+
+// Change detection policies decide whether a recomputed result differs from
+// the cached one. They are invoked as policy(previous, next) only when there
+// is a previous result, and may keep state of their own.
+struct equality {
+    using is_change_detection = void;
+
+    constexpr auto operator()(const auto &previous, const auto &next) const {
+        return previous != next;
+    }
+};
+
+// Uses a user-provided equality comparator.
+template<typename F>
+struct compare_with {
+    using is_change_detection = void;
+
+    F equal;
+
+    constexpr auto operator()(const auto &previous, const auto &next) {
+        return !std::invoke(equal, previous, next);
+    }
+};
+
+template<typename F>
+compare_with(F) -> compare_with<F>;
+
+struct std_hash {
+    auto operator()(const auto &value) const {
+        return std::hash<std::remove_cvref_t<decltype(value)>>{}(value);
+    }
+};
+
+// Compares fingerprints instead of values, such that only the new result
+// needs to be hashed. Results having colliding hashes are considered equal.
+template<typename Hash = std_hash>
+struct hash_fingerprint {
+    using is_change_detection = void;
+
+    Hash hash;
+    std::optional<std::size_t> fingerprint;
+
+    constexpr hash_fingerprint() = default;
+    constexpr explicit hash_fingerprint(Hash hash) : hash{ hash } {}
+
+    constexpr auto operator()(const auto &previous, const auto &next) {
+        if (!fingerprint) fingerprint = std::invoke(hash, previous);
+
+        const auto next_fingerprint = std::invoke(hash, next);
+        const auto changed = next_fingerprint != *fingerprint;
+        fingerprint = next_fingerprint;
+
+        return changed;
+    }
+};
+
+template<typename Hash>
+hash_fingerprint(Hash) -> hash_fingerprint<Hash>;
+
+// For (smart) pointers: only a different pointee counts as a change.
+struct pointer_identity {
+    using is_change_detection = void;
+
+    constexpr auto operator()(const auto &previous, const auto &next) const {
+        return std::to_address(previous) != std::to_address(next);
+    }
+};
+
+struct always_changed {
+    using is_change_detection = void;
+
+    constexpr auto operator()(const auto &, const auto &) const {
+        return true;
+    }
+};
+
+struct bitwise {
+    using is_change_detection = void;
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    auto operator()(const T &previous, const T &next) const {
+        return std::memcmp(&previous, &next, sizeof(T)) != 0;
+    }
+};
+
+} // namespace pigro
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "lazy.h"
+#include "lazy_vector.h"
+#include "regular_void.h"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace pigro::detail {
+
+template<typename F>
+using collection_t = std::remove_cvref_t<decltype(std::declval<F &>()(nullptr).value)>;
+
+template<typename F>
+using element_t = typename collection_t<F>::value_type;
+
+// Patches the output according to the changes of the input collection since
+// the version that was consumed last, or rebuilds it if those are unknown.
+// Returns whether the input changed.
+auto patch_collection(auto &dep, std::size_t &seen, auto &&rebuild, auto &&apply) {
+    const auto result = dep(nullptr);
+    if (result.version == seen) return false;
+
+    if (const auto changes = result.value.changes_since(seen)) {
+        for (const auto &change : *changes) apply(change);
+    } else {
+        rebuild(result.value);
+    }
+
+    seen = result.version;
+    return true;
+}
+
+auto update_element(auto &out, std::size_t index, auto value) {
+    if constexpr (std::equality_comparable<decltype(value)>) {
+        if (out[index] == value) return;
+    }
+
+    out.update(index, std::move(value));
+}
+
+// Keeps the partial results of an associative operation over the leaves, such
+// that updating a single leaf recomputes only the O(log N) partial results on
+// its path to the root. Inserting or erasing shifts the leaves after it, so
+// it recomputes their paths as well.
+template<typename T, typename Op>
+class segment_tree {
+    Op op;
+    T identity;
+    std::size_t size_ = 0;
+    std::size_t capacity = 1;
+    std::vector<T> nodes = std::vector<T>(2, identity); // nodes[1] is the root
+
+    // Recomputes the parents of the leaves in [first, last)
+    auto recompute(std::size_t first, std::size_t last) {
+        first += capacity;
+        last += capacity;
+        while (first > 1) {
+            first /= 2;
+            last = (last - 1) / 2 + 1;
+            for (auto i = first; i < last; ++i) nodes[i] = std::invoke(op, nodes[2 * i], nodes[2 * i + 1]);
+        }
+    }
+
+public:
+    segment_tree(Op op, T identity) : op{ std::move(op) }, identity{ std::move(identity) } {}
+
+    const auto &result() const { return nodes[1]; }
+
+    auto assign(const auto &values) {
+        size_ = values.size();
+        capacity = std::bit_ceil(std::max(size_, std::size_t{ 1 }));
+        nodes.assign(2 * capacity, identity);
+        std::copy(values.begin(), values.end(), nodes.begin() + capacity);
+        recompute(0, capacity);
+    }
+
+    auto insert(std::size_t index, T value) {
+        if (size_ == capacity) {
+            auto leaves = std::vector<T>(nodes.begin() + capacity, nodes.end());
+            capacity *= 2;
+            nodes.assign(2 * capacity, identity);
+            std::move(leaves.begin(), leaves.end(), nodes.begin() + capacity);
+            recompute(0, size_);
+        }
+
+        const auto leaves = nodes.begin() + capacity;
+        std::move_backward(leaves + index, leaves + size_, leaves + size_ + 1);
+        leaves[index] = std::move(value);
+        ++size_;
+        recompute(index, size_);
+    }
+
+    auto erase(std::size_t index) {
+        const auto leaves = nodes.begin() + capacity;
+        std::move(leaves + index + 1, leaves + size_, leaves + index);
+        leaves[size_ - 1] = identity;
+        recompute(index, size_);
+        --size_;
+    }
+
+    auto update(std::size_t index, T value) {
+        nodes[capacity + index] = std::move(value);
+        recompute(index, index + 1);
+    }
+};
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Applies f to every element of the collection, and publishes the changes to
+// the result like lazy_vector. Only changed elements are transformed again,
+// and updates that transform to the same value are not published.
+auto map(auto collection, auto f) {
+    auto dep = detail::ensure_lazy(collection);
+    using result_t = std::remove_cvref_t<std::invoke_result_t<decltype(f) &, const detail::element_t<decltype(dep)> &>>;
+
+    auto lazy_f = compressed_tuple{ dep, f } << [out = vector_state<result_t>{}, seen = std::size_t{}](std::nullptr_t, auto &&dep, auto &&f) mutable {
+        const auto previous = out.version();
+
+        detail::patch_collection(
+          dep,
+          seen,
+          [&](const auto &in) {
+              auto values = std::vector<result_t>{};
+              values.reserve(in.size());
+              for (const auto &value : in) values.push_back(std::invoke(f, value));
+
+              out.assign(std::move(values));
+          },
+          [&](const auto &change) {
+              switch (change.kind) {
+              case change_kind::insert: out.insert(change.index, std::invoke(f, change.value)); break;
+              case change_kind::erase: out.erase(change.index); break;
+              case change_kind::update: detail::update_element(out, change.index, std::invoke(f, change.value)); break;
+              }
+          });
+
+        return detail::LazyResult{
+            out,
+            out.version() != previous,
+            out.version(),
+        };
+    };
+
+    auto unwrapped_lazy_f = detail::unwrap_reference(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+// Keeps the elements of the collection that satisfy the predicate, and
+// publishes the changes to the result like lazy_vector. The predicate is only
+// evaluated again for changed elements.
+auto filter(auto collection, auto pred) {
+    auto dep = detail::ensure_lazy(collection);
+    using element_t = detail::element_t<decltype(dep)>;
+
+    auto lazy_f = compressed_tuple{ dep, pred } << [out = vector_state<element_t>{}, kept = std::vector<bool>{}, seen = std::size_t{}](std::nullptr_t, auto &&dep, auto &&pred) mutable {
+        const auto previous = out.version();
+
+        // The index into the output of the input element at the given index
+        const auto rank = [&](std::size_t index) {
+            return static_cast<std::size_t>(std::count(kept.begin(), kept.begin() + index, true));
+        };
+
+        detail::patch_collection(
+          dep,
+          seen,
+          [&](const auto &in) {
+              auto values = std::vector<element_t>{};
+              kept.clear();
+              for (const auto &value : in) {
+                  kept.push_back(std::invoke(pred, value));
+                  if (kept.back()) values.push_back(value);
+              }
+
+              out.assign(std::move(values));
+          },
+          [&](const auto &change) {
+              const auto index = change.index;
+              switch (change.kind) {
+              case change_kind::insert: {
+                  const auto keep = static_cast<bool>(std::invoke(pred, change.value));
+                  kept.insert(kept.begin() + index, keep);
+                  if (keep) out.insert(rank(index), change.value);
+                  break;
+              }
+              case change_kind::erase:
+                  if (kept[index]) out.erase(rank(index));
+                  kept.erase(kept.begin() + index);
+                  break;
+              case change_kind::update: {
+                  const auto keep = static_cast<bool>(std::invoke(pred, change.value));
+                  const auto was_kept = static_cast<bool>(kept[index]);
+                  kept[index] = keep;
+
+                  if (keep && was_kept) detail::update_element(out, rank(index), change.value);
+                  else if (keep) out.insert(rank(index), change.value);
+                  else if (was_kept) out.erase(rank(index));
+                  break;
+              }
+              }
+          });
+
+        return detail::LazyResult{
+            out,
+            out.version() != previous,
+            out.version(),
+        };
+    };
+
+    auto unwrapped_lazy_f = detail::unwrap_reference(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+// Folds the collection using the associative operation op, of which identity
+// is the identity element. Only the partial results affected by changed
+// elements are recomputed, which takes O(log N) applications of op for an
+// update.
+auto reduce(auto collection, auto op, auto identity) {
+    auto dep = detail::ensure_lazy(collection);
+    using tree_t = detail::segment_tree<decltype(identity), decltype(op)>;
+
+    auto lazy_f = compressed_tuple{ dep } << [tree = tree_t{ op, identity }, cache = detail::versioned_cache<decltype(identity)>{}, seen = std::size_t{}](std::nullptr_t, auto &&dep) mutable {
+        const auto patched = detail::patch_collection(
+          dep,
+          seen,
+          [&](const auto &in) { tree.assign(in); },
+          [&](const auto &change) {
+              switch (change.kind) {
+              case change_kind::insert: tree.insert(change.index, change.value); break;
+              case change_kind::erase: tree.erase(change.index); break;
+              case change_kind::update: tree.update(change.index, change.value); break;
+              }
+          });
+
+        const auto changed = patched && cache.store(tree.result());
+
+        return detail::LazyResult{
+            *cache,
+            changed,
+            cache.version(),
+        };
+    };
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+} // namespace pigro
@@ -9,6 +9,7 @@ template<typename T>
 concept lazy_result = requires(T t) {
     t.value;
     t.is_changed;
+    t.version;
 };
 
 template<typename F>
@@ -20,6 +21,38 @@ concept lazy_function = requires(F f) {
 template<typename F>
 concept lazy_function_unwrapped = lazy_function<F> && ::std::invocable<F>;
 
+template<typename P>
+concept change_detection = requires {
+    typename std::remove_cvref_t<P>::is_change_detection;
+};
+
+template<typename P>
+concept eviction_policy = requires {
+    typename std::remove_cvref_t<P>::is_eviction_policy;
+};
+
+template<typename C>
+concept clock = requires(const C &c) {
+    c.now();
+};
+
+template<typename T>
+concept awaitable = requires(T t) {
+    t.await_ready();
+    t.await_resume();
+};
+
+template<typename F>
+concept async_lazy_function = requires(F f) {
+    { f(nullptr).await_resume() }
+        -> lazy_result;
+};
+
+template<typename E>
+concept executor = requires(E &e) {
+    e.execute(std::declval<void (*)()>());
+};
+
 template<typename T>
 concept empty = std::is_empty_v<std::remove_cvref_t<T>>;
 
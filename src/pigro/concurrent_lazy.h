@@ -0,0 +1,172 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "lazy.h"
+#include "regular_void.h"
+#include "revision.h"
+#include "tuple_algorithms.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pigro::detail {
+
+// Publishes immutable snapshots of the cached value, such that readers never
+// observe a value while it is being replaced. Only stored to while holding
+// the lock of the owning node.
+template<typename T>
+class concurrent_cache {
+    struct snapshot {
+        T value;
+        std::size_t version;
+    };
+
+    std::atomic<std::shared_ptr<const snapshot>> current;
+
+public:
+    auto load() const { return current.load(std::memory_order_acquire); }
+
+    auto store(T &&value) {
+        const auto previous = load();
+        const auto changed = !previous || previous->value != value;
+        if (!changed) return false;
+
+        const auto version = previous ? previous->version + 1 : 1;
+        current.store(std::make_shared<const snapshot>(snapshot{ std::move(value), version }), std::memory_order_release);
+
+        return true;
+    }
+};
+
+// The atomic equivalent of optional<regular_void>: a void function is called
+// only once, no matter how many threads pull it.
+template<>
+class concurrent_cache<regular_void> {
+    struct snapshot {
+        regular_void value;
+        std::size_t version;
+    };
+
+    std::atomic<bool> engaged = false;
+
+public:
+    auto load() const {
+        return engaged.load(std::memory_order_acquire)
+                 ? std::optional{ snapshot{ {}, 1 } }
+                 : std::nullopt;
+    }
+
+    auto store(regular_void) {
+        return !engaged.exchange(true, std::memory_order_acq_rel);
+    }
+};
+
+struct no_revisions {
+    constexpr auto current() const { return std::size_t{}; }
+};
+
+// Pulls are lock-free for as long as the revision counter hasn't been bumped
+// since the last validation. Otherwise, exactly one thread validates (and if
+// needed, recomputes) the node, while the other threads wait for it.
+template<typename Revisions, typename F, typename... Deps>
+struct concurrent_node {
+    using value_t = decltype(std::declval<F &>()(std::declval<Deps &>()(nullptr).value...));
+    using versions_t = std::tuple<decltype(std::declval<Deps &>()(nullptr).version)...>;
+
+    const Revisions *revisions;
+    F f;
+    std::tuple<Deps...> deps;
+
+    versions_t seen = {};
+    std::mutex mutex;
+    std::atomic<bool> validated = false;
+    std::atomic<std::size_t> verified = 0;
+    concurrent_cache<value_t> cache;
+
+    concurrent_node(const Revisions *revisions, F f, Deps... deps)
+      : revisions{ revisions }, f{ std::move(f) }, deps{ std::move(deps)... } {}
+
+    auto is_current() const {
+        return !std::is_same_v<Revisions, no_revisions>
+               && validated.load(std::memory_order_acquire)
+               && verified.load(std::memory_order_acquire) == revisions->current();
+    }
+
+    auto pull() {
+        if (is_current()) return std::pair{ cache.load(), false };
+
+        const auto lock = std::scoped_lock{ mutex };
+        if (is_current()) return std::pair{ cache.load(), false };
+
+        const auto revision = revisions->current();
+
+        const auto args = std::apply([](auto &...deps) { return std::tuple{ deps(nullptr)... }; }, deps);
+        const auto versions = transform(args, version);
+
+        auto changed = !cache.load() || versions != seen;
+        if (changed) {
+            changed = cache.store(std::apply(f, transform_ref(args, value)));
+            seen = versions;
+        }
+
+        verified.store(revision, std::memory_order_release);
+        validated.store(true, std::memory_order_release);
+
+        return std::pair{ cache.load(), changed };
+    }
+};
+
+template<typename Revisions>
+auto concurrent_core(const Revisions &revisions, auto f, concepts::lazy_function auto... deps) {
+    using node_t = concurrent_node<Revisions, decltype(f), decltype(deps)...>;
+
+    auto node = std::make_shared<node_t>(&revisions, std::move(f), std::move(deps)...);
+    return compressed_tuple{ node } << [](std::nullptr_t, auto &&node) {
+        const auto [snapshot, changed] = node->pull();
+
+        return LazyResult<typename node_t::value_t>{
+            snapshot->value,
+            changed,
+            snapshot->version,
+        };
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Can be pulled from multiple threads at the same time, and all copies refer
+// to the same node. Its dependencies are only pulled while holding the lock of
+// the node, so they need to be safe to pull from any thread (e.g. values, or
+// other concurrent lazy functions). Values are returned by copy, since another
+// thread may replace the cached value at any time.
+auto concurrent_lazy(auto f, auto... deps) {
+    static constexpr auto revisions = detail::no_revisions{};
+
+    auto lazy_f = detail::concurrent_core(
+      revisions,
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+auto concurrent_lazy(const atomic_revision_counter &revisions, auto f, auto... deps) {
+    auto lazy_f = detail::concurrent_core(
+      revisions,
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+} // namespace pigro
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "concepts.h"
+#include "lazy.h"
+#include "regular_void.h"
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <latch>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pigro::detail {
+
+struct dag_node_base {
+    std::vector<std::shared_ptr<dag_node_base>> dependencies;
+
+    // Only used while the node is being scheduled
+    bool scheduled = false;
+    bool evaluated = false;
+    std::vector<dag_node_base *> dependents;
+    std::atomic<std::size_t> waiting_for = 0;
+
+    virtual ~dag_node_base() = default;
+    virtual void evaluate() = 0;
+};
+
+// Erases the function of the node, such that graphs of any shape can be built
+// at runtime from nodes having the same value type.
+template<typename T>
+struct dag_value_node : dag_node_base {
+    using value_t = T;
+
+    const T *value = nullptr;
+    std::size_t version = 0;
+    std::size_t cycle = 0;
+
+    // While scheduled, a node is evaluated only after all of its dependencies
+    // were. Otherwise, it behaves like a shared node.
+    auto is_validated() const {
+        if (scheduled) return evaluated;
+        return value && pull_cycle::is_active() && cycle == pull_cycle::current;
+    }
+
+    auto pull() {
+        if (!is_validated()) evaluate();
+    }
+};
+
+template<typename F>
+struct dag_node : dag_value_node<std::remove_cvref_t<decltype(std::declval<F &>()(nullptr).value)>> {
+    F f;
+
+    explicit dag_node(F f) : f{ std::move(f) } {}
+
+    void evaluate() override {
+        const auto result = f(nullptr);
+
+        this->value = &result.value;
+        this->version = result.version;
+        this->cycle = pull_cycle::current;
+        this->evaluated = true;
+    }
+};
+
+template<typename Node>
+class dag_function {
+    std::shared_ptr<Node> node_;
+
+public:
+    explicit dag_function(std::shared_ptr<Node> node) : node_{ std::move(node) } {}
+
+    template<typename Other>
+    requires std::convertible_to<std::shared_ptr<Other>, std::shared_ptr<Node>>
+    dag_function(const dag_function<Other> &other) : node_{ other.node() } {}
+
+    auto &node() const { return node_; }
+
+    auto operator()(std::nullptr_t) const {
+        const auto previous = node_->version;
+        node_->pull();
+
+        return LazyResult{
+            *node_->value,
+            previous != node_->version,
+            node_->version,
+        };
+    }
+
+    auto operator()() const {
+        const auto cycle = pull_cycle{};
+
+        if constexpr (std::is_same_v<typename Node::value_t, regular_void>) {
+            (*this)(nullptr);
+        } else {
+            return (*this)(nullptr).value;
+        }
+    }
+};
+
+template<typename>
+constexpr auto is_dag_function = false;
+
+template<typename Node>
+constexpr auto is_dag_function<dag_function<Node>> = true;
+
+auto add_dependency(dag_node_base &node, const auto &dep) {
+    if constexpr (is_dag_function<std::remove_cvref_t<decltype(dep)>>) {
+        node.dependencies.push_back(dep.node());
+    }
+}
+
+// Finds all nodes reachable from the roots, and links them to their dependents.
+inline auto collect(std::vector<dag_node_base *> roots) {
+    auto nodes = std::vector<dag_node_base *>{};
+
+    auto stack = std::move(roots);
+    while (!stack.empty()) {
+        const auto node = stack.back();
+        stack.pop_back();
+        if (node->scheduled) continue;
+
+        node->scheduled = true;
+        node->evaluated = false;
+        node->dependents.clear();
+        node->waiting_for = node->dependencies.size();
+        nodes.push_back(node);
+
+        for (const auto &dep : node->dependencies) {
+            stack.push_back(dep.get());
+        }
+    }
+
+    for (const auto node : nodes) {
+        for (const auto &dep : node->dependencies) {
+            dep->dependents.push_back(node);
+        }
+    }
+
+    return nodes;
+}
+
+template<typename Executor>
+struct dag_run {
+    Executor *executor;
+    std::shared_ptr<std::latch> done;
+
+    auto submit(dag_node_base *node) -> void {
+        executor->execute([this, node, done = done] {
+            node->evaluate();
+
+            for (const auto dependent : node->dependents) {
+                if (--dependent->waiting_for == 0) submit(dependent);
+            }
+
+            done->count_down();
+        });
+    }
+};
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Any dag lazy function having values of type T (regular_void for void).
+template<typename T>
+using dag_lazy_function = detail::dag_function<detail::dag_value_node<T>>;
+
+// Like shared_lazy, but its dependencies on other dag lazy functions are
+// known, which allows schedule() to evaluate a whole graph in parallel.
+auto dag_lazy(auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      equality{},
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    using node_t = detail::dag_node<decltype(lazy_f)>;
+
+    auto node = std::make_shared<node_t>(std::move(lazy_f));
+    (detail::add_dependency(*node, deps), ...);
+
+    return detail::dag_function{ node };
+}
+
+// Evaluates the graph of dag lazy functions reachable from the roots on the
+// executor, in topological order: a node is evaluated as soon as all of its
+// dependencies were, and only recomputes if any of them changed. Returns the
+// values of the roots. Any dependencies other than dag lazy functions are
+// pulled on the threads of the executor, so they mustn't be shared between
+// nodes (unless that is safe to do from multiple threads).
+auto schedule(concepts::executor auto &executor, const auto &...roots) {
+    const auto nodes = detail::collect({ roots.node().get()... });
+
+    auto run = detail::dag_run<std::remove_cvref_t<decltype(executor)>>{
+        &executor,
+        std::make_shared<std::latch>(static_cast<std::ptrdiff_t>(nodes.size())),
+    };
+
+    // Submitted tasks already start making other nodes ready
+    auto ready = std::vector<detail::dag_node_base *>{};
+    for (const auto node : nodes) {
+        if (node->waiting_for == 0) ready.push_back(node);
+    }
+
+    for (const auto node : ready) {
+        run.submit(node);
+    }
+
+    run.done->wait();
+
+    const auto values = std::tuple<std::remove_cvref_t<decltype(roots(nullptr).value)>...>{ roots(nullptr).value... };
+    for (const auto node : nodes) {
+        node->scheduled = false;
+    }
+
+    return values;
+}
+
+} // namespace pigro
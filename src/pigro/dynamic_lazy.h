@@ -0,0 +1,119 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "lazy.h"
+#include "regular_void.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pigro::detail {
+
+// The dependencies that were read during the last evaluation, in the order in
+// which they were first read, together with the versions that were read.
+template<typename Versions>
+struct dependency_reads;
+
+template<typename... Versions>
+struct dependency_reads<std::tuple<Versions...>> {
+    std::tuple<std::optional<Versions>...> seen;
+    std::array<std::size_t, sizeof...(Versions)> order = {};
+    std::size_t count = 0;
+
+    template<std::size_t I>
+    auto record(auto version) {
+        auto &seen_version = std::get<I>(seen);
+        if (!seen_version) order[count++] = I;
+
+        seen_version = version;
+    }
+
+    auto clear() {
+        seen = {};
+        count = 0;
+    }
+};
+
+// Passed to the function instead of the value of a dependency, which is only
+// pulled once the handle is invoked.
+template<std::size_t I, typename Dep, typename Reads>
+struct dependency_handle {
+    Dep *dep;
+    Reads *reads;
+
+    decltype(auto) operator()() const {
+        const auto result = (*dep)(nullptr);
+        reads->template record<I>(result.version);
+
+        return decltype(result.value)(result.value);
+    }
+};
+
+// Invokes f on the I-th element of the tuple, for a runtime index
+template<std::size_t... I>
+auto visit_at(auto &tuple, std::size_t index, [[maybe_unused]] auto f, std::index_sequence<I...>) {
+    ((index == I ? f(std::integral_constant<std::size_t, I>{}, std::get<I>(tuple)) : void()), ...);
+}
+
+template<typename F, typename Reads, typename Deps, std::size_t... I>
+auto dynamic_result(std::index_sequence<I...>)
+  -> decltype(std::declval<F &>()(dependency_handle<I, std::tuple_element_t<I, Deps>, Reads>{}...));
+
+constexpr auto dynamic_core(auto f, concepts::lazy_function auto... deps) {
+    using versions_t = std::tuple<decltype(deps(nullptr).version)...>;
+    using reads_t = dependency_reads<versions_t>;
+    using indices_t = std::index_sequence_for<decltype(deps)...>;
+
+    using result_t = decltype(dynamic_result<decltype(f), reads_t, std::tuple<decltype(deps)...>>(indices_t{}));
+
+    return compressed_tuple{ f, std::tuple{ deps... } } << [cache = versioned_cache<result_t>{}, reads = reads_t{}](std::nullptr_t, auto &&f, auto &&dependencies) mutable {
+        // Re-validates the dependencies that were read last time, in the same
+        // order, until one of them changed
+        auto is_valid = static_cast<bool>(cache);
+        for (auto i = std::size_t{}; is_valid && i < reads.count; ++i) {
+            visit_at(dependencies, reads.order[i], [&](auto index, auto &dep) {
+                is_valid = dep(nullptr).version == *std::get<index>(reads.seen);
+            },
+              indices_t{});
+        }
+
+        auto changed = false;
+        if (!is_valid) {
+            reads.clear();
+            changed = cache.update([&] {
+                return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return f(dependency_handle<I, std::remove_reference_t<decltype(std::get<I>(dependencies))>, decltype(reads)>{ &std::get<I>(dependencies), &reads }...);
+                }(indices_t{});
+            });
+        }
+
+        return LazyResult{
+            *cache,
+            changed,
+            cache.version(),
+        };
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Passes a handle for every dependency to f, which pulls the dependency only
+// when invoked. Only the dependencies that were read during the last
+// evaluation are validated, such that dependencies on branches that were not
+// taken are not pulled at all.
+auto dynamic_lazy(auto f, auto... deps) {
+    auto lazy_f = detail::dynamic_core(
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+} // namespace pigro
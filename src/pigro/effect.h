@@ -0,0 +1,152 @@
+#pragma once
+
+#include "lazy.h"
+#include "regular_void.h"
+#include "subscription.h"
+
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <utility>
+
+namespace pigro {
+
+class effect_scheduler;
+
+} // namespace pigro
+
+namespace pigro::detail {
+
+class effect_node_base : public subscriber {
+    friend effect_scheduler;
+
+    effect_scheduler *scheduler;
+    std::size_t order;
+    bool dirty = false;
+
+protected:
+    effect_node_base(effect_scheduler &scheduler);
+    ~effect_node_base();
+
+    effect_node_base(const effect_node_base &) = delete;
+    effect_node_base &operator=(const effect_node_base &) = delete;
+
+    virtual void run() = 0;
+
+public:
+    void notify() override;
+};
+
+template<typename F>
+struct effect_node final : effect_node_base {
+    F f;
+
+    effect_node(effect_scheduler &scheduler, F f)
+      : effect_node_base{ scheduler }, f{ std::move(f) } {}
+
+    void run() override {
+        const auto previous = std::exchange(subscriber::current, this);
+        {
+            const auto cycle = pull_cycle{};
+            f(nullptr);
+        }
+        subscriber::current = previous;
+    }
+};
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Runs the effects whose sources were written since the previous flush. Each
+// of them is run at most once per flush (unless it is notified again while
+// flushing), in the order in which they were created. As dependencies are
+// always created before their dependents, this is a topological order.
+class effect_scheduler {
+    friend detail::effect_node_base;
+
+    std::size_t created = 0;
+    std::set<std::pair<std::size_t, detail::effect_node_base *>> pending_;
+
+    void schedule(detail::effect_node_base &node) {
+        if (std::exchange(node.dirty, true)) return;
+        pending_.emplace(node.order, &node);
+    }
+
+    void forget(detail::effect_node_base &node) {
+        if (node.dirty) pending_.erase({ node.order, &node });
+    }
+
+public:
+    effect_scheduler() = default;
+
+    effect_scheduler(const effect_scheduler &) = delete;
+    effect_scheduler &operator=(const effect_scheduler &) = delete;
+
+    auto pending() const { return pending_.size(); }
+
+    // Returns the number of effects that were run
+    auto flush() {
+        auto runs = std::size_t{};
+        while (!pending_.empty()) {
+            const auto node = pending_.begin()->second;
+            pending_.erase(pending_.begin());
+            node->dirty = false;
+
+            // Keeps the node alive in case it is disposed of while running
+            const auto keep_alive = node->shared_from_this();
+            node->run();
+            ++runs;
+        }
+
+        return runs;
+    }
+};
+
+// Keeps the effect alive; the effect is disposed of together with its last copy.
+class effect_handle {
+    std::shared_ptr<detail::subscriber> node;
+
+public:
+    explicit effect_handle(std::shared_ptr<detail::subscriber> node)
+      : node{ std::move(node) } {}
+
+    auto dispose() { node.reset(); }
+};
+
+} // namespace pigro
+
+namespace pigro::detail {
+
+inline effect_node_base::effect_node_base(effect_scheduler &scheduler)
+  : scheduler{ &scheduler }, order{ scheduler.created++ } {}
+
+inline effect_node_base::~effect_node_base() { scheduler->forget(*this); }
+
+inline void effect_node_base::notify() { scheduler->schedule(*this); }
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Registers a reaction to its dependencies, which is run by the next flush of
+// the scheduler, and from then on only after a source that it (transitively)
+// depends on was written and any of its dependencies actually changed. Sources
+// are the only dependencies that notify effects; other functions are polled
+// only when the effect runs. The scheduler needs to outlive the effect.
+[[nodiscard]] auto effect(effect_scheduler &scheduler, auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      equality{},
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    using node_t = detail::effect_node<decltype(lazy_f)>;
+
+    const auto node = std::make_shared<node_t>(scheduler, std::move(lazy_f));
+    node->notify();
+
+    return effect_handle{ node };
+}
+
+} // namespace pigro
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "lazy.h"
+#include "regular_void.h"
+#include "tuple_algorithms.h"
+
+#include <functional>
+#include <tuple>
+
+namespace pigro {
+
+// Pulls all of the lazy functions within a single pull cycle, such that the
+// shared lazy functions among their ancestors are validated only once. Returns
+// the tuple of their values, having regular_void for void functions.
+auto evaluate(auto &...fs) {
+    const auto cycle = detail::pull_cycle{};
+
+    return transform(std::tie(fs...), [](auto &f) {
+        return regularized_void(std::ref(f))();
+    });
+}
+
+} // namespace pigro
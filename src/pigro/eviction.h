@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace pigro {
+
+struct cache_stats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+
+    auto hit_ratio() const {
+        const auto accesses = hits + misses;
+        return accesses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(accesses);
+    }
+};
+
+// Bookkeeping of a single cache entry, from which eviction policies rank the
+// entries. Entries with the lowest rank are evicted first.
+struct eviction_info {
+    std::size_t uses = 0;
+    std::size_t last_used = 0;
+    std::size_t cost = 0;
+};
+
+// Keeps every entry.
+struct unbounded {
+    using is_eviction_policy = void;
+
+    static constexpr auto capacity = std::numeric_limits<std::size_t>::max();
+    static constexpr auto stats = static_cast<cache_stats *>(nullptr);
+
+    constexpr auto rank(const eviction_info &) const { return 0; }
+    constexpr auto cost(const auto &) const { return std::size_t{ 1 }; }
+};
+
+// Keeps at most capacity entries, evicting the least recently used ones.
+struct lru {
+    using is_eviction_policy = void;
+
+    std::size_t capacity;
+    cache_stats *stats = nullptr;
+
+    constexpr auto rank(const eviction_info &info) const { return info.last_used; }
+    constexpr auto cost(const auto &) const { return std::size_t{ 1 }; }
+};
+
+// Keeps at most capacity entries, evicting the least frequently used ones
+// (and the least recently used ones among those).
+struct lfu {
+    using is_eviction_policy = void;
+
+    std::size_t capacity;
+    cache_stats *stats = nullptr;
+
+    constexpr auto rank(const eviction_info &info) const { return std::pair{ info.uses, info.last_used }; }
+    constexpr auto cost(const auto &) const { return std::size_t{ 1 }; }
+};
+
+// Keeps the total cost of the cached values (as computed by cost_of) within
+// capacity, evicting the least recently used ones.
+template<typename F>
+struct cost_aware {
+    using is_eviction_policy = void;
+
+    std::size_t capacity;
+    F cost_of;
+    cache_stats *stats = nullptr;
+
+    constexpr auto rank(const eviction_info &info) const { return info.last_used; }
+    constexpr auto cost(const auto &value) const { return static_cast<std::size_t>(std::invoke(cost_of, value)); }
+};
+
+template<typename F>
+cost_aware(std::size_t, F, cache_stats * = nullptr) -> cost_aware<F>;
+
+} // namespace pigro
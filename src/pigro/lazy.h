@@ -1,92 +1,244 @@
 #pragma once
 
 #include "bind_tuple.h"
+#include "change_detection.h"
 #include "compressed_tuple.h"
 #include "overload.h"
 #include "recursive.h"
 #include "regular_void.h"
+#include "revision.h"
 #include "tuple_algorithms.h"
 
 #include <concepts>
 #include <cstddef>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 namespace pigro::detail {
 
-template<typename T>
+// The version increases every time the value changes, which allows any
+// number of dependents to find out whether the value changed since they last
+// consumed it. The is_changed flag only tells whether this particular pull
+// changed the value. Values that never change use an empty version type,
+// such that dependents don't need to store it.
+template<typename T, typename V = std::size_t>
 struct LazyResult {
     T value;
     bool is_changed;
+    V version;
 };
 
-template<typename T>
-LazyResult(const T &, bool) -> LazyResult<const T &>;
-LazyResult(int &&, bool)->LazyResult<int>;
+template<typename T, typename V>
+LazyResult(const T &, bool, V) -> LazyResult<const T &, V>;
+LazyResult(int &&, bool, std::size_t)->LazyResult<int>;
 
-constexpr auto value = [](const concepts::lazy_result auto result) {
+using constant_version = std::integral_constant<std::size_t, 0>;
+
+constexpr auto value = [](const concepts::lazy_result auto &result) -> const auto & {
     return result.value;
 };
 
-constexpr auto is_changed = [](const concepts::lazy_result auto result) {
+constexpr auto is_changed = [](const concepts::lazy_result auto &result) {
     return result.is_changed;
 };
 
+constexpr auto version = [](const concepts::lazy_result auto &result) {
+    return result.version;
+};
+
+// Converts to the result of f, such that the result can be constructed in
+// place by anything that accepts a T (guaranteed copy elision).
+template<typename F>
+struct materialize {
+    F &f;
+    operator std::invoke_result_t<F &>() const { return f(); }
+};
+
+// Inherits from the policy, such that stateless policies take no space.
+template<typename T, concepts::change_detection Policy = equality>
+struct versioned_cache : private Policy {
+    std::optional<T> value;
+    std::size_t changes = 0;
+
+    versioned_cache() = default;
+    explicit versioned_cache(Policy policy) : Policy{ policy } {}
+
+    explicit operator bool() const { return static_cast<bool>(value); }
+    const auto &operator*() const { return *value; }
+
+    auto version() const { return changes; }
+
+    auto store(auto &&result) {
+        const auto changed = !value || static_cast<Policy &>(*this)(*value, result);
+        if (changed) {
+            value = std::forward<decltype(result)>(result);
+            ++changes;
+        }
+
+        return changed;
+    }
+
+    // The first result is constructed directly in the cache. Later results
+    // are kept alive only for the comparison, and moved into the cache.
+    auto update(std::invocable auto &&make) {
+        if (!value) {
+            value.emplace(materialize<std::remove_reference_t<decltype(make)>>{ make });
+            ++changes;
+            return true;
+        }
+
+        return store(make());
+    }
+};
+
+// A void function can only change once (from not called, to called),
+// so its version is implied by the cache itself.
+template<typename Policy>
+struct versioned_cache<regular_void, Policy> {
+    std::optional<regular_void> value;
+
+    versioned_cache() = default;
+    explicit versioned_cache(Policy) {}
+
+    explicit operator bool() const { return static_cast<bool>(value); }
+    auto operator*() const { return *value; }
+
+    auto version() const { return std::size_t{ static_cast<bool>(value) }; }
+
+    auto store(regular_void result) {
+        const auto changed = value != result;
+        value = result;
+
+        return changed;
+    }
+
+    auto update(std::invocable auto &&make) { return store(make()); }
+};
+
+// Every top-level pull of a lazy function forms a pull cycle, during which
+// shared nodes are validated only once.
+struct pull_cycle {
+    static inline thread_local auto depth = std::size_t{};
+    static inline thread_local auto current = std::size_t{};
+
+    pull_cycle() {
+        if (depth++ == 0) ++current;
+    }
+
+    ~pull_cycle() { --depth; }
+
+    pull_cycle(const pull_cycle &) = delete;
+    pull_cycle &operator=(const pull_cycle &) = delete;
+
+    static auto is_active() { return depth != 0; }
+};
+
 constexpr auto unwrap_value(concepts::lazy_function auto f) {
     return recursive{
         overload{
-          compressed_tuple{ f } << [](auto &self, std::nullptr_t, auto f) { return f(nullptr); },
+          compressed_tuple{ std::move(f) } << [](auto &self, std::nullptr_t, auto &&f) { return f(nullptr); },
           [](auto &self) mutable {
+              const auto cycle = pull_cycle{};
+              return self(nullptr).value;
+          },
+        }
+    };
+}
+
+// Returns a reference into the cache of the lazy function, which stays valid
+// until the next pull of that same lazy function (or until it is destroyed).
+constexpr auto unwrap_reference(concepts::lazy_function auto f) {
+    return recursive{
+        overload{
+          compressed_tuple{ std::move(f) } << [](auto &self, std::nullptr_t, auto &&f) { return f(nullptr); },
+          [](auto &self) mutable -> const auto & {
+              const auto cycle = pull_cycle{};
               return self(nullptr).value;
           },
         }
     };
 }
 
-constexpr auto lazy(auto f, concepts::lazy_function auto... deps) {
+struct unrevisioned {
+    constexpr auto is_current() const { return false; }
+    constexpr auto verify() const {}
+};
+
+struct revisioned {
+    const revision_counter *revisions;
+    std::size_t verified = 0;
+
+    constexpr auto is_current() const { return verified == revisions->current(); }
+    constexpr auto verify() { verified = revisions->current(); }
+};
+
+constexpr auto lazy_core(auto stamp, auto policy, auto f, concepts::lazy_function auto... deps) {
     using result_t = decltype(f(deps(nullptr).value...));
+    using versions_t = std::tuple<decltype(deps(nullptr).version)...>;
+
+    return compressed_tuple{ stamp, versions_t{}, f, deps... } << [cache = versioned_cache<result_t, decltype(policy)>{ policy }](std::nullptr_t, auto &&stamp, auto &&seen, auto &&f, auto &&...deps) mutable {
+        if (cache && stamp.is_current()) {
+            return LazyResult{
+                *cache,
+                false,
+                cache.version(),
+            };
+        }
+
+        stamp.verify();
 
-    auto cache = std::optional<result_t>{};
-    return compressed_tuple{ f, deps... } << [=](std::nullptr_t, auto f, auto... deps) mutable {
         const auto args = std::tuple{ deps(nullptr)... };
+        const auto versions = transform(args, version);
 
-        auto changed = !cache || any(args, is_changed);
+        auto changed = !cache || versions != seen;
         if (changed) {
-            const auto values = transform(args, value);
-            const auto result = std::apply(f, values);
-
-            changed = cache != result;
-            cache = std::move(result);
+            changed = cache.update([&] { return std::apply(f, transform_ref(args, value)); });
+            seen = versions;
         }
 
         return LazyResult{
             *cache,
             changed,
+            cache.version(),
         };
     };
 }
 
-constexpr auto lazy_value(auto value, auto changed) {
-    return compressed_tuple{ value, changed } << [](std::nullptr_t, auto value, auto changed) {
+constexpr auto lazy_value(auto value) {
+    return compressed_tuple{ value } << [](std::nullptr_t, auto &&value) {
         return LazyResult{
             value,
-            changed,
+            false,
+            constant_version{},
         };
     };
 };
 
+constexpr auto poll(auto dep) {
+    using result_t = decltype(dep());
+
+    return compressed_tuple{ dep } << [cache = versioned_cache<result_t>{}](std::nullptr_t, auto &&dep) mutable {
+        const auto changed = cache.update(dep);
+
+        return LazyResult{
+            *cache,
+            changed,
+            cache.version(),
+        };
+    };
+}
+
 constexpr auto ensure_lazy(concepts::lazy_function_unwrapped auto dep) {
     return dep;
 }
 
 constexpr auto ensure_lazy(::std::invocable auto dep) {
-    return detail::lazy(
-      compressed_tuple{ dep } << [](auto, auto dep) mutable { return dep(); },
-      lazy_value(0, std::true_type{}));
+    return poll(dep);
 }
 
 constexpr auto ensure_lazy(auto dep) {
-    return lazy_value(dep, std::false_type{});
+    return lazy_value(dep);
 }
 
 } // namespace pigro::detail
@@ -94,12 +246,63 @@ constexpr auto ensure_lazy(auto dep) {
 namespace pigro {
 
 auto lazy(auto f, auto... deps) {
-    auto lazy_f = detail::lazy(
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      equality{},
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+// Skips pulling any of its dependencies for as long as the revision counter
+// hasn't been bumped since the last pull. Function dependencies are therefore
+// only polled after a bump.
+auto lazy(const revision_counter &revisions, auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::revisioned{ &revisions },
+      equality{},
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+// Uses the given policy to decide whether a recomputed result has changed,
+// instead of comparing it to the previous one using operator!=.
+auto lazy(concepts::change_detection auto policy, auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      policy,
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+auto lazy_ref(auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      equality{},
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_reference(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+auto lazy_ref(concepts::change_detection auto policy, auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      policy,
       regularized_void(f),
       detail::ensure_lazy(deps)...);
 
-    auto unwrapped_lazy_f = detail::unwrap_value(lazy_f);
-    return unregularized_void(unwrapped_lazy_f);
+    auto unwrapped_lazy_f = detail::unwrap_reference(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
 }
 
 } // namespace pigro
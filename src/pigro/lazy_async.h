@@ -0,0 +1,198 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "concepts.h"
+#include "lazy.h"
+#include "overload.h"
+#include "regular_void.h"
+#include "task.h"
+#include "tuple_algorithms.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pigro::detail {
+
+template<typename T>
+struct ready_awaiter {
+    T value;
+
+    constexpr auto await_ready() const noexcept { return true; }
+    constexpr auto await_suspend(std::coroutine_handle<>) const noexcept {}
+    constexpr auto await_resume() -> T { return std::move(value); }
+};
+
+constexpr auto ensure_awaitable(concepts::awaitable auto &&awaitable) -> decltype(auto) {
+    return FWD(awaitable);
+}
+
+constexpr auto ensure_awaitable(auto &&value) {
+    return ready_awaiter<std::remove_cvref_t<decltype(value)>>{ FWD(value) };
+}
+
+template<typename T>
+using await_result_t = decltype(ensure_awaitable(std::declval<T>()).await_resume());
+
+template<typename T>
+using regularized_t = std::conditional_t<std::is_void_v<T>, regular_void, T>;
+
+// Polls a function returning an awaitable on every pull, like poll() does for
+// plain functions.
+template<typename F>
+struct async_poll_node {
+    using value_t = regularized_t<await_result_t<decltype(std::declval<F &>()())>>;
+
+    F f;
+    versioned_cache<value_t> cache;
+};
+
+template<typename Node>
+auto pull_async_poll(std::shared_ptr<Node> node) -> task<LazyResult<const typename Node::value_t &>> {
+    auto &state = *node;
+
+    auto changed = false;
+    if constexpr (std::is_same_v<typename Node::value_t, regular_void>) {
+        co_await state.f();
+        changed = state.cache.store(regular_void{});
+    } else {
+        changed = state.cache.store(co_await state.f());
+    }
+
+    co_return LazyResult<const typename Node::value_t &>{
+        *state.cache,
+        changed,
+        state.cache.version(),
+    };
+}
+
+constexpr auto async_poll(auto dep) {
+    using node_t = async_poll_node<decltype(dep)>;
+
+    auto node = std::make_shared<node_t>(node_t{ dep, {} });
+    return compressed_tuple{ node } << [](std::nullptr_t, auto &&node) {
+        return pull_async_poll(node);
+    };
+}
+
+constexpr auto ensure_async(auto dep) {
+    if constexpr (concepts::async_lazy_function<decltype(dep)>) {
+        return dep;
+    } else if constexpr (requires { { dep() } -> concepts::awaitable; }) {
+        return async_poll(dep);
+    } else {
+        return ensure_lazy(dep);
+    }
+}
+
+// While a pull is suspended (e.g. waiting for I/O), any other pulls of the
+// same node wait for it to finish, instead of evaluating the node again.
+template<typename F, typename... Deps>
+struct async_node {
+    using args_t = std::tuple<await_result_t<decltype(std::declval<Deps &>()(nullptr))>...>;
+    using versions_t = std::tuple<decltype(std::declval<await_result_t<decltype(std::declval<Deps &>()(nullptr))>>().version)...>;
+    using call_t = decltype(std::apply(std::declval<F &>(), transform_ref(std::declval<const args_t &>(), value)));
+    using value_t = regularized_t<await_result_t<call_t>>;
+    using result_t = LazyResult<std::conditional_t<std::is_same_v<value_t, regular_void>, regular_void, const value_t &>>;
+    using indices_t = std::index_sequence_for<Deps...>;
+
+    F f;
+    std::tuple<Deps...> deps;
+
+    versions_t seen = {};
+    versioned_cache<value_t> cache;
+
+    bool pulling = false;
+    std::vector<std::coroutine_handle<>> waiters;
+
+    async_node(F f, Deps... deps)
+      : f{ std::move(f) }, deps{ std::move(deps)... } {}
+};
+
+struct wait_for_pull {
+    std::vector<std::coroutine_handle<>> &waiters;
+
+    constexpr auto await_ready() const noexcept { return false; }
+    auto await_suspend(std::coroutine_handle<> handle) { waiters.push_back(handle); }
+    constexpr auto await_resume() const noexcept {}
+};
+
+template<typename Node, std::size_t... I>
+auto pull_async(std::shared_ptr<Node> node, std::index_sequence<I...>) -> task<typename Node::result_t> {
+    using result_t = typename Node::result_t;
+    auto &state = *node;
+
+    if (state.pulling) {
+        co_await wait_for_pull{ state.waiters };
+        co_return result_t{ *state.cache, false, state.cache.version() };
+    }
+
+    state.pulling = true;
+
+    const auto args = typename Node::args_t{ co_await ensure_awaitable(std::get<I>(state.deps)(nullptr))... };
+    const auto versions = transform(args, version);
+
+    auto changed = !state.cache || versions != state.seen;
+    if (changed) {
+        using call_t = typename Node::call_t;
+
+        if constexpr (!concepts::awaitable<call_t>) {
+            changed = state.cache.update([&] { return std::apply(state.f, transform_ref(args, value)); });
+        } else if constexpr (std::is_void_v<await_result_t<call_t>>) {
+            co_await std::apply(state.f, transform_ref(args, value));
+            changed = state.cache.store(regular_void{});
+        } else {
+            changed = state.cache.store(co_await std::apply(state.f, transform_ref(args, value)));
+        }
+
+        state.seen = versions;
+    }
+
+    state.pulling = false;
+    for (auto waiter : std::exchange(state.waiters, {})) {
+        waiter.resume();
+    }
+
+    co_return result_t{ *state.cache, changed, state.cache.version() };
+}
+
+template<typename Node>
+using unregularized_t = std::conditional_t<std::is_same_v<typename Node::value_t, regular_void>, void, typename Node::value_t>;
+
+template<typename Node>
+auto pull_async_value(std::shared_ptr<Node> node) -> task<unregularized_t<Node>> {
+    if constexpr (std::is_same_v<typename Node::value_t, regular_void>) {
+        co_await pull_async(node, typename Node::indices_t{});
+    } else {
+        const auto result = co_await pull_async(node, typename Node::indices_t{});
+        co_return result.value;
+    }
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Both the function and its dependencies may return awaitables. Pulling the
+// returned lazy function returns a task, which can be awaited for its value.
+// All copies refer to the same node, which needs to be pulled from a single
+// thread (e.g. an event loop).
+auto lazy_async(auto f, auto... deps) {
+    using node_t = detail::async_node<decltype(regularized_void(f)), decltype(detail::ensure_async(deps))...>;
+
+    auto node = std::make_shared<node_t>(regularized_void(f), detail::ensure_async(deps)...);
+    return compressed_tuple{ node } << overload{
+        [](std::nullptr_t, auto &&node) {
+            return detail::pull_async(node, typename node_t::indices_t{});
+        },
+        [](auto &&node) {
+            return detail::pull_async_value(node);
+        },
+    };
+}
+
+} // namespace pigro
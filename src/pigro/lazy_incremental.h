@@ -0,0 +1,81 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "lazy.h"
+#include "tuple_algorithms.h"
+
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pigro::detail {
+
+template<std::size_t... I>
+auto changed_mask(const auto &versions, const auto &seen, std::index_sequence<I...>) {
+    auto mask = std::bitset<sizeof...(I)>{};
+    ((mask[I] = std::get<I>(versions) != std::get<I>(seen)), ...);
+
+    return mask;
+}
+
+constexpr auto incremental_core(auto initial, auto update, concepts::lazy_function auto... deps) {
+    using versions_t = std::tuple<decltype(deps(nullptr).version)...>;
+    using indices_t = std::index_sequence_for<decltype(deps)...>;
+
+    return compressed_tuple{ versions_t{}, update, deps... } << [result = std::move(initial), updates = std::size_t{}](std::nullptr_t, auto &&seen, auto &&update, auto &&...deps) mutable {
+        const auto args = std::tuple{ deps(nullptr)... };
+        const auto versions = transform(args, version);
+
+        auto changes = changed_mask(versions, seen, indices_t{});
+        if (updates == 0) changes.set();
+
+        auto changed = false;
+        if (updates == 0 || changes.any()) {
+            changed = std::apply([&](const auto &...values) {
+                using update_result_t = decltype(update(result, changes, values...));
+
+                if constexpr (std::same_as<update_result_t, void>) {
+                    update(result, changes, values...);
+                    return true;
+                } else {
+                    return static_cast<bool>(update(result, changes, values...));
+                }
+            },
+              transform_ref(args, value));
+
+            changed = changed || updates == 0;
+            if (changed) ++updates;
+            seen = versions;
+        }
+
+        return LazyResult{
+            result,
+            changed,
+            updates,
+        };
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Patches the previous result instead of recomputing it from scratch. The
+// update function is invoked as update(result, changes, values...), where
+// result starts out as the initial value, and changes is a std::bitset that
+// tells which dependencies changed (all of them, at the first evaluation).
+// It may return whether it changed the result, which otherwise is assumed.
+auto lazy_incremental(auto initial, auto update, auto... deps) {
+    auto lazy_f = detail::incremental_core(
+      std::move(initial),
+      update,
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+} // namespace pigro
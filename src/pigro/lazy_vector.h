@@ -0,0 +1,177 @@
+#pragma once
+
+#include "lazy.h"
+#include "revision.h"
+#include "subscription.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace pigro {
+
+enum class change_kind { insert, erase, update };
+
+// Inserts and updates carry the new value, while erasures carry the erased one.
+template<typename T>
+struct vector_change {
+    change_kind kind;
+    std::size_t index;
+    T value;
+
+    auto operator==(const vector_change &) const -> bool = default;
+};
+
+// A vector that logs its changes, such that consumers can patch their own
+// results, instead of recomputing them from scratch. Every change bumps the
+// version by one, and consumers that remember the version they consumed last
+// can ask for the changes made since.
+template<typename T>
+class vector_state {
+    std::vector<T> values_;
+    std::size_t version_ = 1;
+
+    // log[i] was made by version base + i + 1
+    std::vector<vector_change<T>> log;
+    std::size_t base = 1;
+
+    auto record(vector_change<T> change) {
+        // Consumers that are this far behind are better off starting over
+        if (log.size() >= std::max(values_.size(), std::size_t{ 64 })) {
+            const auto half = log.size() / 2;
+            log.erase(log.begin(), log.begin() + half);
+            base += half;
+        }
+
+        log.push_back(std::move(change));
+        ++version_;
+    }
+
+public:
+    using value_type = T;
+
+    vector_state() = default;
+    explicit vector_state(std::vector<T> values) : values_{ std::move(values) } {}
+
+    const auto &values() const { return values_; }
+    auto size() const { return values_.size(); }
+    auto empty() const { return values_.empty(); }
+    const auto &operator[](std::size_t index) const { return values_[index]; }
+    auto begin() const { return values_.begin(); }
+    auto end() const { return values_.end(); }
+
+    auto version() const { return version_; }
+
+    // The changes made since the given version, or nothing if they are not
+    // known (anymore), in which case consumers need to start over.
+    std::optional<std::span<const vector_change<T>>> changes_since(std::size_t version) const {
+        if (version < base || version > version_) return std::nullopt;
+
+        return std::span{ log }.subspan(version - base);
+    }
+
+    auto insert(std::size_t index, T value) {
+        values_.insert(values_.begin() + index, value);
+        record({ change_kind::insert, index, std::move(value) });
+    }
+
+    auto push_back(T value) { insert(size(), std::move(value)); }
+
+    auto erase(std::size_t index) {
+        auto value = std::move(values_[index]);
+        values_.erase(values_.begin() + index);
+        record({ change_kind::erase, index, std::move(value) });
+    }
+
+    auto update(std::size_t index, T value) {
+        values_[index] = value;
+        record({ change_kind::update, index, std::move(value) });
+    }
+
+    // Replaces all values, which is not expressed as changes.
+    auto assign(std::vector<T> values) {
+        values_ = std::move(values);
+        log.clear();
+        base = ++version_;
+    }
+};
+
+// A mutable input vector, which publishes its changes to its dependents along
+// with its values. All copies refer to the same vector.
+template<typename T>
+class lazy_vector {
+    struct cell {
+        vector_state<T> state;
+        std::size_t pulled = 0;
+        revision_counter *revisions = nullptr;
+        detail::subscriptions subscriptions = {};
+    };
+
+    std::shared_ptr<cell> state;
+
+    auto bump() {
+        if (state->revisions) state->revisions->bump();
+        state->subscriptions.notify();
+    }
+
+public:
+    explicit lazy_vector(std::vector<T> values = {})
+      : state{ std::make_shared<cell>(cell{ vector_state<T>{ std::move(values) } }) } {}
+
+    lazy_vector(revision_counter &revisions, std::vector<T> values = {})
+      : state{ std::make_shared<cell>(cell{ vector_state<T>{ std::move(values) }, 0, &revisions }) } {}
+
+    auto operator()(std::nullptr_t) const {
+        state->subscriptions.track();
+
+        const auto changed = state->pulled != state->state.version();
+        state->pulled = state->state.version();
+
+        return detail::LazyResult{
+            state->state,
+            changed,
+            state->state.version(),
+        };
+    }
+
+    const auto &operator()() const { return state->state; }
+
+    auto version() const { return state->state.version(); }
+
+    auto insert(std::size_t index, T value) {
+        state->state.insert(index, std::move(value));
+        bump();
+    }
+
+    auto push_back(T value) {
+        state->state.push_back(std::move(value));
+        bump();
+    }
+
+    auto erase(std::size_t index) {
+        state->state.erase(index);
+        bump();
+    }
+
+    auto update(std::size_t index, T value) {
+        state->state.update(index, std::move(value));
+        bump();
+    }
+
+    auto assign(std::vector<T> values) {
+        state->state.assign(std::move(values));
+        bump();
+    }
+};
+
+template<typename T>
+lazy_vector(std::vector<T>) -> lazy_vector<T>;
+
+template<typename T>
+lazy_vector(revision_counter &, std::vector<T>) -> lazy_vector<T>;
+
+} // namespace pigro
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "concepts.h"
+#include "eviction.h"
+#include "lazy.h"
+#include "regular_void.h"
+#include "tuple_algorithms.h"
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace pigro::detail {
+
+struct tuple_hash {
+    auto operator()(const auto &tuple) const {
+        return std::apply([](const auto &...elements) {
+            auto seed = std::size_t{};
+            ((seed ^= std::hash<std::remove_cvref_t<decltype(elements)>>{}(elements) + 0x9e3779b9 + (seed << 6) + (seed >> 2)), ...);
+            return seed;
+        },
+          tuple);
+    }
+};
+
+template<typename T, typename Versions>
+struct memo_entry {
+    versioned_cache<T> cache;
+    Versions seen = {};
+    eviction_info usage = {};
+};
+
+// Hash table of memo entries, which evicts entries according to the policy.
+template<typename Key, typename Entry, typename Policy>
+class memo_table {
+    static constexpr auto bounded = !std::same_as<Policy, unbounded>;
+
+    using rank_t = decltype(std::declval<Policy>().rank(eviction_info{}));
+
+    Policy policy;
+    std::unordered_map<Key, Entry, tuple_hash> entries;
+    std::map<rank_t, const Key *> ranking;
+    std::size_t tick = 0;
+    std::size_t total_cost = 0;
+
+public:
+    explicit memo_table(Policy policy)
+        : policy{ policy } {}
+
+    auto &touch(const Key &key) {
+        auto &[stored_key, entry] = *entries.try_emplace(key).first;
+
+        if constexpr (bounded) {
+            if (entry.usage.uses != 0) ranking.erase(policy.rank(entry.usage));
+            ++entry.usage.uses;
+            entry.usage.last_used = ++tick;
+            ranking.emplace(policy.rank(entry.usage), &stored_key);
+        }
+
+        return entry;
+    }
+
+    void record(bool hit) {
+        if (policy.stats == nullptr) return;
+
+        ++(hit ? policy.stats->hits : policy.stats->misses);
+    }
+
+    void update_cost(Entry &entry) {
+        if constexpr (bounded) {
+            total_cost -= entry.usage.cost;
+            entry.usage.cost = policy.cost(*entry.cache);
+            total_cost += entry.usage.cost;
+        }
+    }
+
+    // Evicts entries until the total cost fits within the capacity, while
+    // keeping the entry that was touched most recently.
+    void evict(const Entry &current) {
+        if constexpr (bounded) {
+            auto it = ranking.begin();
+            while (total_cost > policy.capacity && it != ranking.end()) {
+                const auto entry_it = entries.find(*it->second);
+                if (&entry_it->second == &current) {
+                    ++it;
+                    continue;
+                }
+
+                total_cost -= entry_it->second.usage.cost;
+                it = ranking.erase(it);
+                entries.erase(entry_it);
+
+                if (policy.stats != nullptr) ++policy.stats->evictions;
+            }
+        }
+    }
+
+    auto size() const { return entries.size(); }
+};
+
+template<typename... Args>
+constexpr auto memoize_core(auto policy, auto f, concepts::lazy_function auto... deps) {
+    using key_t = std::tuple<Args...>;
+    using result_t = decltype(f(std::declval<const Args &>()..., deps(nullptr).value...));
+    using versions_t = std::tuple<decltype(deps(nullptr).version)...>;
+    using table_t = memo_table<key_t, memo_entry<result_t, versions_t>, decltype(policy)>;
+
+    return compressed_tuple{ f, deps... } << [table = table_t{ policy }](const Args &...keys, auto &&f, auto &&...deps) mutable {
+        const auto cycle = pull_cycle{};
+
+        auto &entry = table.touch(key_t{ keys... });
+
+        const auto args = std::tuple{ deps(nullptr)... };
+        const auto versions = transform(args, version);
+
+        const auto hit = entry.cache && versions == entry.seen;
+        table.record(hit);
+
+        if (!hit) {
+            entry.cache.update([&] {
+                return std::apply([&](const auto &...values) { return f(keys..., values...); }, transform_ref(args, value));
+            });
+
+            entry.seen = versions;
+            table.update_cost(entry);
+        }
+
+        auto result = *entry.cache;
+        table.evict(entry);
+
+        return result;
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Caches the results of f per tuple of arguments (of types Args), where every
+// entry validates the dependencies on its own. The values of the dependencies
+// are passed to f after the arguments. The eviction policy (e.g. lru, lfu, or
+// cost_aware) bounds the cache, and evicted entries are recomputed on their
+// next access.
+template<typename... Args>
+auto memoize(concepts::eviction_policy auto policy, auto f, auto... deps) {
+    auto memoized_f = detail::memoize_core<Args...>(
+      policy,
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    return unregularized_void(std::move(memoized_f));
+}
+
+template<typename... Args>
+auto memoize(auto f, auto... deps) {
+    return memoize<Args...>(unbounded{}, f, deps...);
+}
+
+} // namespace pigro
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "concepts.h"
+#include "lazy.h"
+#include "regular_void.h"
+#include "thread_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace pigro::detail {
+
+// Runs on whichever thread comes first: a thread of the executor, or the
+// thread joining it. The latter never waits for a task that didn't start
+// yet, which avoids deadlocks when all threads of the executor are busy
+// (e.g. pulling parallel lazy functions themselves).
+class forked_task {
+    struct state {
+        std::atomic<bool> claimed = false;
+        std::atomic<bool> done = false;
+    };
+
+    std::shared_ptr<state> shared = std::make_shared<state>();
+
+public:
+    auto fork(auto &executor, auto &work) {
+        executor.execute([shared = shared, &work] {
+            if (shared->claimed.exchange(true)) return;
+
+            work();
+            shared->done = true;
+            shared->done.notify_all();
+        });
+    }
+
+    auto join(auto &work) {
+        if (!shared->claimed.exchange(true)) return work();
+
+        shared->done.wait(false);
+    }
+};
+
+// Combines the dependencies into a single lazy function, whose value is the
+// tuple of all of their values. All but the first dependency are pulled on
+// the executor, while the first one is pulled by the calling thread.
+constexpr auto parallel_pull(concepts::executor auto &executor, concepts::lazy_function auto... deps) {
+    return compressed_tuple{ deps... } << [&executor](std::nullptr_t, auto &&...deps) {
+        auto results = std::tuple<std::optional<decltype(deps(nullptr))>...>{};
+
+        const auto pull_into = [](auto &dep, auto &result) {
+            return [&] { result.emplace(dep(nullptr)); };
+        };
+
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            [[maybe_unused]] auto pulls = std::tuple{ pull_into(deps, std::get<I>(results))... };
+            [[maybe_unused]] auto tasks = std::array<forked_task, sizeof...(I)>{};
+
+            ((I != 0 ? tasks[I].fork(executor, std::get<I>(pulls)) : void()), ...);
+            (tasks[I].join(std::get<I>(pulls)), ...);
+
+            using values_t = std::tuple<decltype(std::get<I>(results)->value)...>;
+            using versions_t = std::tuple<decltype(std::get<I>(results)->version)...>;
+
+            return LazyResult<values_t, versions_t>{
+                values_t{ std::move(std::get<I>(results)->value)... },
+                (std::get<I>(results)->is_changed || ...),
+                versions_t{ std::get<I>(results)->version... },
+            };
+        }(std::index_sequence_for<decltype(deps)...>{});
+    };
+}
+
+inline auto &default_thread_pool() {
+    static auto pool = thread_pool{};
+    return pool;
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Pulls the dependencies in parallel on the given executor, which should
+// outlive the returned lazy function. Since dependencies are pulled on other
+// threads, they must not share any state (e.g. the same shared_lazy) unless
+// that is safe to pull from multiple threads.
+auto parallel_lazy(concepts::executor auto &executor, auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      equality{},
+      regularized_void(compressed_tuple{ f } >> [](auto &&f, const auto &args) {
+          return std::apply(f, args);
+      }),
+      detail::parallel_pull(executor, detail::ensure_lazy(deps)...));
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+auto parallel_lazy(auto f, auto... deps) {
+    return parallel_lazy(detail::default_thread_pool(), f, deps...);
+}
+
+} // namespace pigro
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "concepts.h"
+#include "lazy.h"
+#include "regular_void.h"
+#include "shared_lazy.h"
+#include "to_tuple.h"
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pigro::detail {
+
+constexpr auto project_core(concepts::lazy_function auto dep, auto projection) {
+    using result_t = std::remove_cvref_t<std::invoke_result_t<decltype(projection) &, decltype(dep(nullptr).value)>>;
+    using version_t = decltype(dep(nullptr).version);
+
+    return compressed_tuple{ dep, projection } << [cache = versioned_cache<result_t>{}, seen = version_t{}](std::nullptr_t, auto &&dep, auto &&projection) mutable {
+        const auto result = dep(nullptr);
+
+        auto changed = !cache || result.version != seen;
+        if (changed) {
+            changed = cache.update([&] { return std::invoke(projection, result.value); });
+            seen = result.version;
+        }
+
+        return LazyResult{
+            *cache,
+            changed,
+            cache.version(),
+        };
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Tracks changes of a part of the value of the lazy function (e.g. a member
+// pointer), such that dependents are not recomputed when any other part
+// changes. Projections of the same lazy function should share it (see split).
+auto project(auto f, auto projection) {
+    auto lazy_f = detail::project_core(detail::ensure_lazy(f), projection);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+// Splits a lazy function with a tuple-like result into a projection per
+// element, which share the lazy function.
+auto split(auto f) {
+    auto shared_f = unregularized_void(detail::unwrap_value(detail::share(detail::ensure_lazy(f))));
+
+    using value_t = std::remove_cvref_t<decltype(shared_f(nullptr).value)>;
+    constexpr auto size = std::tuple_size_v<value_t>;
+
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return std::tuple{
+            project(shared_f, [](const auto &value) -> const auto & { return std::get<I>(to_tuple(value)); })...,
+        };
+    }(std::make_index_sequence<size>{});
+}
+
+} // namespace pigro
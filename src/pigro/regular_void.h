@@ -5,6 +5,7 @@
 
 #include <concepts>
 #include <optional>
+#include <type_traits>
 
 namespace pigro {
 
@@ -13,27 +14,27 @@ struct regular_void {
 };
 
 constexpr auto regularized_void(auto f) {
-    return compressed_tuple{ f } >> [](auto f, auto... args) mutable {
-        using result_t = decltype(f(args...));
+    return compressed_tuple{ std::move(f) } >> [](auto &&f, auto &&...args) mutable {
+        using result_t = decltype(f(FWD(args)...));
 
         if constexpr (std::same_as<result_t, void>) {
-            f(args...);
+            f(FWD(args)...);
             return regular_void{};
         } else {
-            return f(args...);
+            return f(FWD(args)...);
         }
     };
 }
 
 constexpr auto unregularized_void(auto f) {
-    return compressed_tuple{ f } >> [](auto f, auto... args) mutable {
-        using result_t = decltype(f(args...));
+    return compressed_tuple{ std::move(f) } >> [](auto &&f, auto &&...args) mutable -> decltype(auto) {
+        using result_t = std::remove_cvref_t<decltype(f(FWD(args)...))>;
 
         if constexpr (std::same_as<result_t, regular_void>) {
-            f(args...);
+            f(FWD(args)...);
             return;
         } else {
-            return f(args...);
+            return f(FWD(args)...);
         }
     };
 }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace pigro {
+
+class revision_counter {
+    std::size_t revision = 0;
+
+public:
+    constexpr auto current() const { return revision; }
+    constexpr auto bump() { return ++revision; }
+};
+
+// Can be bumped and read from multiple threads at the same time.
+class atomic_revision_counter {
+    std::atomic<std::size_t> revision = 0;
+
+public:
+    auto current() const { return revision.load(std::memory_order_acquire); }
+    auto bump() { return revision.fetch_add(1, std::memory_order_acq_rel) + 1; }
+};
+
+} // namespace pigro
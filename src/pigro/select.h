@@ -0,0 +1,63 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "lazy.h"
+#include "regular_void.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace pigro::detail {
+
+constexpr auto select_core(concepts::lazy_function auto cond, concepts::lazy_function auto then_f, concepts::lazy_function auto else_f) {
+    using result_t = std::common_type_t<
+      std::remove_cvref_t<decltype(then_f(nullptr).value)>,
+      std::remove_cvref_t<decltype(else_f(nullptr).value)>>;
+
+    return compressed_tuple{ cond, then_f, else_f } << [cache = versioned_cache<result_t>{}, selected = false, seen = std::size_t{}](std::nullptr_t, auto &&cond, auto &&then_f, auto &&else_f) mutable {
+        const auto take_then = static_cast<bool>(cond(nullptr).value);
+
+        auto changed = false;
+        const auto pull = [&](auto &branch) {
+            const auto result = branch(nullptr);
+            const auto version = static_cast<std::size_t>(result.version);
+
+            if (!cache || take_then != selected || version != seen) {
+                changed = cache.update([&] { return result_t(result.value); });
+                selected = take_then;
+                seen = version;
+            }
+        };
+
+        if (take_then) {
+            pull(then_f);
+        } else {
+            pull(else_f);
+        }
+
+        return LazyResult{
+            *cache,
+            changed,
+            cache.version(),
+        };
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Pulls the condition, and only then the branch that it selects. Switching
+// between branches only counts as a change if the values are different.
+auto select(auto cond, auto then_f, auto else_f) {
+    auto lazy_f = detail::select_core(
+      detail::ensure_lazy(cond),
+      detail::ensure_lazy(then_f),
+      detail::ensure_lazy(else_f));
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+} // namespace pigro
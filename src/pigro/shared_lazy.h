@@ -0,0 +1,82 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "lazy.h"
+#include "regular_void.h"
+#include "revision.h"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace pigro::detail {
+
+template<typename F>
+struct shared_node {
+    using value_t = std::remove_cvref_t<decltype(std::declval<F &>()(nullptr).value)>;
+
+    F f;
+    const value_t *value = nullptr;
+    std::size_t version = 0;
+    std::size_t cycle = 0;
+
+    auto is_validated() const {
+        return value && pull_cycle::is_active() && cycle == pull_cycle::current;
+    }
+
+    auto pull() {
+        if (!is_validated()) {
+            const auto result = f(nullptr);
+
+            value = &result.value;
+            version = result.version;
+            cycle = pull_cycle::current;
+        }
+    }
+};
+
+// All copies of the returned handle refer to the same node. Dependents
+// find out about changes through the version of the node.
+constexpr auto share(concepts::lazy_function auto f) {
+    using node_t = shared_node<decltype(f)>;
+
+    auto node = std::make_shared<node_t>(node_t{ f });
+    return compressed_tuple{ node } << [](std::nullptr_t, auto &&node) {
+        const auto previous = node->version;
+        node->pull();
+
+        return LazyResult{
+            *node->value,
+            previous != node->version,
+            node->version,
+        };
+    };
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+auto shared_lazy(auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::unrevisioned{},
+      equality{},
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(detail::share(lazy_f));
+    return unregularized_void(unwrapped_lazy_f);
+}
+
+auto shared_lazy(const revision_counter &revisions, auto f, auto... deps) {
+    auto lazy_f = detail::lazy_core(
+      detail::revisioned{ &revisions },
+      equality{},
+      regularized_void(f),
+      detail::ensure_lazy(deps)...);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(detail::share(lazy_f));
+    return unregularized_void(unwrapped_lazy_f);
+}
+
+} // namespace pigro
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "lazy.h"
+#include "revision.h"
+#include "subscription.h"
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace pigro {
+
+// A mutable input cell. Every write bumps its version, such that dependents
+// find out about changes without polling or comparing the value. All copies
+// of a source refer to the same cell.
+template<typename T>
+class source {
+    struct cell {
+        T value;
+        std::size_t version = 1;
+        std::size_t pulled = 0;
+        revision_counter *revisions = nullptr;
+        detail::subscriptions subscriptions = {};
+    };
+
+    std::shared_ptr<cell> state;
+
+    auto bump() {
+        ++state->version;
+        if (state->revisions) state->revisions->bump();
+        state->subscriptions.notify();
+    }
+
+public:
+    explicit source(T value)
+      : state{ std::make_shared<cell>(cell{ std::move(value) }) } {}
+
+    // Also bumps the revision counter on every write, for dependents that
+    // are revisioned using that same counter.
+    source(revision_counter &revisions, T value)
+      : state{ std::make_shared<cell>(cell{ std::move(value), 1, 0, &revisions }) } {}
+
+    auto operator()(std::nullptr_t) const {
+        state->subscriptions.track();
+
+        const auto changed = state->pulled != state->version;
+        state->pulled = state->version;
+
+        return detail::LazyResult{
+            state->value,
+            changed,
+            state->version,
+        };
+    }
+
+    const auto &operator()() const { return state->value; }
+
+    auto version() const { return state->version; }
+
+    auto set(T value) {
+        state->value = std::move(value);
+        bump();
+    }
+
+    auto modify(std::invocable<T &> auto f) {
+        std::invoke(f, state->value);
+        bump();
+    }
+};
+
+} // namespace pigro
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace pigro::detail {
+
+// While a subscriber pulls its dependencies, the sources that it (transitively)
+// pulls subscribe it, and notify it once they are written.
+struct subscriber : std::enable_shared_from_this<subscriber> {
+    static inline thread_local subscriber *current = nullptr;
+
+    virtual void notify() = 0;
+
+protected:
+    ~subscriber() = default;
+};
+
+class subscriptions {
+    std::vector<std::weak_ptr<subscriber>> subscribers;
+
+public:
+    void track() {
+        if (!subscriber::current) return;
+
+        for (const auto &existing : subscribers) {
+            if (existing.lock().get() == subscriber::current) return;
+        }
+
+        subscribers.push_back(subscriber::current->weak_from_this());
+    }
+
+    void notify() {
+        std::erase_if(subscribers, [](const auto &existing) { return existing.expired(); });
+
+        for (const auto &existing : subscribers) {
+            if (const auto locked = existing.lock()) locked->notify();
+        }
+    }
+};
+
+} // namespace pigro::detail
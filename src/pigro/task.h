@@ -0,0 +1,217 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace pigro {
+
+template<typename T>
+class task;
+
+} // namespace pigro
+
+namespace pigro::detail {
+
+struct continue_with_awaiter {
+    constexpr auto await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) const noexcept -> std::coroutine_handle<> {
+        return handle.promise().continuation;
+    }
+
+    constexpr auto await_resume() const noexcept {}
+};
+
+struct task_promise_base {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr exception;
+
+    auto initial_suspend() const noexcept { return std::suspend_always{}; }
+    auto final_suspend() const noexcept { return continue_with_awaiter{}; }
+
+    auto unhandled_exception() { exception = std::current_exception(); }
+
+    auto rethrow() const {
+        if (exception) std::rethrow_exception(exception);
+    }
+};
+
+template<typename T>
+struct task_promise : task_promise_base {
+    std::optional<T> value;
+
+    auto get_return_object() -> task<T>;
+    auto return_value(T result) { value.emplace(std::move(result)); }
+
+    auto result() -> T {
+        rethrow();
+        return std::move(*value);
+    }
+};
+
+template<>
+struct task_promise<void> : task_promise_base {
+    auto get_return_object() -> task<void>;
+    auto return_void() {}
+
+    auto result() { rethrow(); }
+};
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// A coroutine that only starts running once it is awaited. When it finishes,
+// the awaiting coroutine is resumed right away (symmetric transfer).
+template<typename T = void>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::task_promise<T>;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    explicit task(std::coroutine_handle<promise_type> handle) : handle{ handle } {}
+
+    task(task &&other) noexcept : handle{ std::exchange(other.handle, {}) } {}
+
+    task &operator=(task &&other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+
+        return *this;
+    }
+
+    ~task() {
+        if (handle) handle.destroy();
+    }
+
+    auto await_ready() const noexcept { return false; }
+
+    auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<> {
+        handle.promise().continuation = continuation;
+        return handle;
+    }
+
+    auto await_resume() -> T { return handle.promise().result(); }
+};
+
+} // namespace pigro
+
+namespace pigro::detail {
+
+template<typename T>
+auto task_promise<T>::get_return_object() -> task<T> {
+    return task<T>{ std::coroutine_handle<task_promise>::from_promise(*this) };
+}
+
+inline auto task_promise<void>::get_return_object() -> task<void> {
+    return task<void>{ std::coroutine_handle<task_promise>::from_promise(*this) };
+}
+
+// Signals the thread that is blocked in sync_wait() once it finishes.
+struct blocking_task {
+    struct signal {
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool done = false;
+
+        auto notify() {
+            const auto lock = std::scoped_lock{ mutex };
+            done = true;
+            condition.notify_all();
+        }
+
+        auto wait() {
+            auto lock = std::unique_lock{ mutex };
+            condition.wait(lock, [&] { return done; });
+        }
+    };
+
+    struct promise_type {
+        signal *finished = nullptr;
+
+        auto get_return_object() {
+            return blocking_task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        auto initial_suspend() const noexcept { return std::suspend_always{}; }
+
+        auto final_suspend() const noexcept {
+            struct notify_awaiter {
+                constexpr auto await_ready() const noexcept { return false; }
+                auto await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                    handle.promise().finished->notify();
+                }
+                constexpr auto await_resume() const noexcept {}
+            };
+
+            return notify_awaiter{};
+        }
+
+        auto return_void() {}
+        auto unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit blocking_task(std::coroutine_handle<promise_type> handle) : handle{ handle } {}
+    blocking_task(const blocking_task &) = delete;
+    ~blocking_task() { handle.destroy(); }
+
+    auto run() {
+        auto finished = signal{};
+        handle.promise().finished = &finished;
+        handle.resume();
+        finished.wait();
+    }
+};
+
+template<typename T>
+auto await_into(task<T> &task, std::optional<T> &result, std::exception_ptr &exception) -> blocking_task {
+    try {
+        result.emplace(co_await std::move(task));
+    } catch (...) {
+        exception = std::current_exception();
+    }
+}
+
+inline auto await_into(task<void> &task, std::exception_ptr &exception) -> blocking_task {
+    try {
+        co_await std::move(task);
+    } catch (...) {
+        exception = std::current_exception();
+    }
+}
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Blocks the calling thread until the task has finished, and returns its result.
+template<typename T>
+auto sync_wait(task<T> task) -> T {
+    auto exception = std::exception_ptr{};
+
+    if constexpr (std::is_void_v<T>) {
+        detail::await_into(task, exception).run();
+        if (exception) std::rethrow_exception(exception);
+    } else {
+        auto result = std::optional<T>{};
+        detail::await_into(task, result, exception).run();
+        if (exception) std::rethrow_exception(exception);
+
+        return std::move(*result);
+    }
+}
+
+} // namespace pigro
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pigro {
+
+// A fixed number of threads executing tasks in the order they were submitted.
+// Tasks that didn't start yet when the pool is destroyed are discarded.
+class thread_pool {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool stopping = false;
+
+    std::vector<std::jthread> threads;
+
+    auto run() {
+        while (true) {
+            auto task = std::function<void()>{};
+            {
+                auto lock = std::unique_lock{ mutex };
+                condition.wait(lock, [&] { return stopping || !tasks.empty(); });
+                if (stopping) return;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+public:
+    explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency()) {
+        thread_count = std::max(thread_count, std::size_t{ 1 });
+        for (auto i = std::size_t{}; i < thread_count; ++i) {
+            threads.emplace_back([this] { run(); });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            const auto lock = std::scoped_lock{ mutex };
+            stopping = true;
+        }
+
+        condition.notify_all();
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    auto size() const { return threads.size(); }
+
+    auto execute(std::function<void()> task) {
+        {
+            const auto lock = std::scoped_lock{ mutex };
+            tasks.push_back(std::move(task));
+        }
+
+        condition.notify_one();
+    }
+};
+
+} // namespace pigro
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "compressed_tuple.h"
+#include "concepts.h"
+#include "lazy.h"
+#include "regular_void.h"
+
+#include <chrono>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace pigro::detail {
+
+struct fixed_rate {
+    // Keeps to the cadence of the previous samples, unless the next one is
+    // already overdue
+    auto next(auto previous, auto now, auto interval) const {
+        const auto next = previous + interval;
+        return next <= now ? now + interval : next;
+    }
+};
+
+struct fixed_age {
+    auto next(auto, auto now, auto duration) const { return now + duration; }
+};
+
+constexpr auto sampled_core(const concepts::clock auto &clock, auto schedule, concepts::lazy_function auto dep, auto period) {
+    using value_t = std::remove_cvref_t<decltype(dep(nullptr).value)>;
+    using version_t = decltype(dep(nullptr).version);
+    using time_point_t = decltype(clock.now());
+
+    return compressed_tuple{ schedule, dep } << [&clock, period, cache = versioned_cache<value_t>{}, seen = version_t{}, next = time_point_t{}](std::nullptr_t, auto &&schedule, auto &&dep) mutable {
+        const auto now = clock.now();
+
+        auto changed = false;
+        if (!cache || now >= next) {
+            const auto result = dep(nullptr);
+            if (!cache || result.version != seen) {
+                changed = cache.update([&] { return value_t(result.value); });
+                seen = result.version;
+            }
+
+            next = schedule.next(next, now, period);
+        }
+
+        return LazyResult{
+            *cache,
+            changed,
+            cache.version(),
+        };
+    };
+}
+
+inline const auto steady_clock = std::chrono::steady_clock{};
+
+} // namespace pigro::detail
+
+namespace pigro {
+
+// Pulls the dependency at most once per interval, at a steady rate, and
+// reuses the previous value in between. The clock can be anything with a
+// now() member function (e.g. a manual clock in tests), which needs to
+// outlive the returned lazy function.
+auto throttle(const concepts::clock auto &clock, auto dep, auto interval) {
+    auto lazy_f = detail::sampled_core(
+      clock,
+      detail::fixed_rate{},
+      detail::ensure_lazy(dep),
+      interval);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+auto throttle(auto dep, auto interval) {
+    return throttle(detail::steady_clock, dep, interval);
+}
+
+// Reuses the value of the dependency until it is older than the duration, and
+// only then pulls the dependency again.
+auto ttl(const concepts::clock auto &clock, auto dep, auto duration) {
+    auto lazy_f = detail::sampled_core(
+      clock,
+      detail::fixed_age{},
+      detail::ensure_lazy(dep),
+      duration);
+
+    auto unwrapped_lazy_f = detail::unwrap_value(std::move(lazy_f));
+    return unregularized_void(std::move(unwrapped_lazy_f));
+}
+
+auto ttl(auto dep, auto duration) {
+    return ttl(detail::steady_clock, dep, duration);
+}
+
+} // namespace pigro
@@ -2,12 +2,24 @@
 
 #include <functional>
 #include <tuple>
+#include <type_traits>
 
 namespace pigro {
 
+// Elements that are references to non-const objects are projected as such.
 constexpr auto transform(const auto &data, auto projection) {
+    return std::apply([=](auto &&...args) {
+        // Not using CTAD, which would unwrap a single projected tuple
+        return std::tuple<std::decay_t<decltype(projection(args))>...>{ projection(args)... };
+    },
+      data);
+}
+
+// Unlike transform(), keeps the exact types returned by the projection, such
+// that projecting onto references doesn't copy the referenced values.
+constexpr auto transform_ref(const auto &data, auto projection) {
     return std::apply([=](const auto &...args) {
-        return std::tuple{ projection(args)... };
+        return std::tuple<decltype(projection(args))...>{ projection(args)... };
     },
       data);
 }
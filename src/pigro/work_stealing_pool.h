@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pigro {
+
+// Every thread has its own queue. Tasks submitted from one of the threads of
+// the pool are pushed to its own queue and popped in LIFO order (which keeps
+// caches warm), while idle threads steal the oldest tasks from the others.
+// Tasks that didn't start yet when the pool is destroyed are discarded.
+class work_stealing_pool {
+    struct queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::atomic<std::size_t> next = 0;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<std::size_t> pending = 0;
+    bool stopping = false;
+
+    std::vector<std::jthread> threads;
+
+    struct worker {
+        const work_stealing_pool *pool;
+        std::size_t index;
+    };
+
+    static inline thread_local auto current = worker{};
+
+    auto pop(std::size_t index) -> std::optional<std::function<void()>> {
+        auto &own = *queues[index];
+        {
+            const auto lock = std::scoped_lock{ own.mutex };
+            if (!own.tasks.empty()) {
+                auto task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return task;
+            }
+        }
+
+        for (auto i = std::size_t{ 1 }; i < queues.size(); ++i) {
+            auto &victim = *queues[(index + i) % queues.size()];
+
+            const auto lock = std::scoped_lock{ victim.mutex };
+            if (!victim.tasks.empty()) {
+                auto task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return task;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    auto run(std::size_t index) {
+        current = worker{ this, index };
+
+        while (true) {
+            if (auto task = pop(index)) {
+                --pending;
+                (*task)();
+                continue;
+            }
+
+            auto lock = std::unique_lock{ mutex };
+            condition.wait(lock, [&] { return stopping || pending != 0; });
+            if (stopping) return;
+        }
+    }
+
+public:
+    explicit work_stealing_pool(std::size_t thread_count = std::thread::hardware_concurrency()) {
+        thread_count = std::max(thread_count, std::size_t{ 1 });
+        for (auto i = std::size_t{}; i < thread_count; ++i) {
+            queues.push_back(std::make_unique<queue>());
+        }
+
+        for (auto i = std::size_t{}; i < thread_count; ++i) {
+            threads.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    ~work_stealing_pool() {
+        {
+            const auto lock = std::scoped_lock{ mutex };
+            stopping = true;
+        }
+
+        condition.notify_all();
+    }
+
+    work_stealing_pool(const work_stealing_pool &) = delete;
+    work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+    auto size() const { return threads.size(); }
+
+    auto execute(std::function<void()> task) {
+        const auto index = current.pool == this
+                             ? current.index
+                             : next++ % queues.size();
+
+        {
+            const auto lock = std::scoped_lock{ mutex };
+            ++pending;
+        }
+
+        {
+            auto &target = *queues[index];
+            const auto lock = std::scoped_lock{ target.mutex };
+            target.tasks.push_back(std::move(task));
+        }
+
+        condition.notify_one();
+    }
+};
+
+} // namespace pigro
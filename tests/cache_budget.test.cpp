@@ -0,0 +1,131 @@
+#include "../src/pigro/cache_budget.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite cache_budget_tests = [] {
+    "cached_bytes"_test = [] {
+        expect(cached_bytes(42) == sizeof(int));
+        expect(cached_bytes(vector<int>(10)) == sizeof(vector<int>) + 10 * sizeof(int));
+        expect(cached_bytes(string(100, 'x')) == sizeof(string) + 100);
+    };
+
+    "release"_test = [] {
+        auto budget = cache_budget{ 2 * sizeof(vector<char>) + 150 };
+
+        auto counters = vector<int>(2);
+        auto image = [&](int index, int size) {
+            return lazy(budget, [&, index](int size) {
+                ++counters[index];
+                return vector<char>(size);
+            },
+              size);
+        };
+
+        auto foo = image(0, 100);
+        auto bar = image(1, 100);
+
+        expect(foo().size() == 100_ul);
+        expect(budget.used() == sizeof(vector<char>) + 100);
+
+        // Exceeds the budget, so foo releases its value
+        expect(bar().size() == 100_ul);
+        expect(budget.evictions() == 1_ul);
+        expect(budget.used() == sizeof(vector<char>) + 100);
+
+        expect(bar().size() == 100_ul);
+        expect(counters == vector{ 1, 1 });
+
+        // Recomputes on the next pull
+        expect(foo().size() == 100_ul);
+        expect(counters == vector{ 2, 1 });
+        expect(budget.evictions() == 2_ul);
+    };
+
+    "keeps_versions"_test = [] {
+        auto budget = cache_budget{ 0 };
+
+        auto x = 1;
+        auto foo_counter = 0;
+        auto foo = lazy(budget, [&](int x) {
+            ++foo_counter;
+            return x * 2;
+        },
+          [&] { return x; });
+
+        auto bar_counter = 0;
+        auto bar = lazy([&](int foo) {
+            ++bar_counter;
+            return foo + 1;
+        },
+          foo);
+
+        expect(bar() == 3_i);
+
+        // Outside of a pull, every value is released
+        budget.trim();
+        expect(budget.used() == 0_ul);
+
+        // Recomputing foo with the same dependencies doesn't change its version
+        expect(bar() == 3_i);
+        expect(foo_counter == 2_i);
+        expect(bar_counter == 1_i);
+
+        budget.trim();
+        x = 2;
+        expect(bar() == 5_i);
+        expect(foo_counter == 3_i);
+        expect(bar_counter == 2_i);
+    };
+
+    "hot_values"_test = [] {
+        auto budget = cache_budget{ 0 };
+
+        auto foo = lazy(budget, [] { return string(100, 'x'); });
+        auto bar = lazy(budget, [] { return string(100, 'y'); });
+
+        // Both values are needed during the same pull, so none is released
+        auto baz = lazy([](const string &foo, const string &bar) { return foo + bar; }, foo, bar);
+        expect(baz() == string(100, 'x') + string(100, 'y'));
+        expect(budget.evictions() == 0_ul);
+
+        budget.trim();
+        expect(budget.evictions() == 2_ul);
+    };
+
+    "lifetime"_test = [] {
+        auto budget = cache_budget{ 1'000 };
+        {
+            auto foo = lazy(budget, [] { return 42; });
+            auto copy = foo;
+            expect(copy() == 42_i);
+            expect(budget.used() == sizeof(int));
+        }
+
+        expect(budget.used() == 0_ul);
+    };
+
+    "void"_test = [] {
+        auto budget = cache_budget{ 0 };
+
+        auto counter = 0;
+        auto foo = lazy(budget, [&] { ++counter; });
+        expect(type<decltype(foo())> == type<void>);
+
+        foo();
+        budget.trim();
+        foo();
+        expect(counter == 1_i);
+        expect(budget.used() == 0_ul);
+    };
+};
+
+} // namespace pigro::tests
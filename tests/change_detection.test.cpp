@@ -0,0 +1,160 @@
+#include "../src/pigro/change_detection.h"
+#include "../src/pigro/lazy.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite change_detection_tests = [] {
+    "equality"_test = [] {
+        auto policy = equality{};
+        expect(!policy(1, 1));
+        expect(policy(1, 2));
+    };
+
+    "compare_with"_test = [] {
+        auto comparisons = 0;
+        auto policy = compare_with{ [&](const auto &lhs, const auto &rhs) {
+            ++comparisons;
+            return lhs.size() == rhs.size();
+        } };
+
+        expect(!policy(vector{ 1, 2 }, vector{ 3, 4 }));
+        expect(policy(vector{ 1, 2 }, vector{ 1 }));
+        expect(comparisons == 2_i);
+    };
+
+    "hash_fingerprint"_test = [] {
+        auto hashes = 0;
+        auto policy = hash_fingerprint{ [&](int value) {
+            ++hashes;
+            return static_cast<size_t>(value % 10);
+        } };
+
+        expect(!policy(1, 1));
+        expect(hashes == 2_i);
+
+        // The fingerprint of the previous result is remembered
+        expect(policy(1, 2));
+        expect(hashes == 3_i);
+
+        // Colliding hashes count as unchanged
+        expect(!policy(2, 12));
+        expect(hashes == 4_i);
+
+        auto std_policy = hash_fingerprint{};
+        expect(!std_policy(42, 42));
+        expect(std_policy(42, 43));
+    };
+
+    "pointer_identity"_test = [] {
+        auto policy = pointer_identity{};
+
+        const auto a = make_shared<int>(1);
+        const auto b = make_shared<int>(1);
+        expect(!policy(a, a));
+        expect(policy(a, b));
+
+        auto x = 1;
+        auto y = 1;
+        expect(!policy(&x, &x));
+        expect(policy(&x, &y));
+    };
+
+    "always_changed"_test = [] {
+        auto policy = always_changed{};
+        expect(policy(1, 1));
+        expect(policy(1, 2));
+    };
+
+    "bitwise"_test = [] {
+        auto policy = bitwise{};
+        expect(!policy(array{ 1, 2, 3 }, array{ 1, 2, 3 }));
+        expect(policy(array{ 1, 2, 3 }, array{ 1, 2, 4 }));
+    };
+
+    "lazy"_test = [] {
+        auto x = 1;
+
+        auto foo_comparisons = 0;
+        auto foo = lazy(
+          compare_with{ [&](int lhs, int rhs) {
+              ++foo_comparisons;
+              return lhs == rhs;
+          } },
+          [](int x) { return x % 2; },
+          [&] { return x; });
+
+        auto bar_counter = 0;
+        auto bar = lazy([&](int foo) {
+            ++bar_counter;
+            return foo + 1;
+        },
+          foo);
+
+        expect(bar() == 2_i);
+        expect(foo_comparisons == 0_i);
+        expect(bar_counter == 1_i);
+
+        x = 3;
+        expect(bar() == 2_i);
+        expect(foo_comparisons == 1_i);
+        expect(bar_counter == 1_i);
+
+        x = 4;
+        expect(bar() == 1_i);
+        expect(foo_comparisons == 2_i);
+        expect(bar_counter == 2_i);
+
+        auto baz = lazy(always_changed{}, [](int x) { return x % 2; }, [&] { return x; });
+        auto qux_counter = 0;
+        auto qux = lazy([&](int baz) {
+            ++qux_counter;
+            return baz;
+        },
+          baz);
+
+        expect(qux() == 0_i);
+        expect(qux_counter == 1_i);
+
+        expect(qux() == 0_i);
+        expect(qux_counter == 1_i);
+
+        // Recomputes to the same value, but is considered changed anyway
+        x = 6;
+        expect(qux() == 0_i);
+        expect(qux_counter == 2_i);
+    };
+
+    "lazy_ref"_test = [] {
+        auto x = 0;
+        auto image = lazy_ref(
+          pointer_identity{},
+          [](int) { return make_shared<const vector<int>>(1'000'000, 42); },
+          [&] { return x; });
+
+        const auto first = image().get();
+        expect(image().get() == first);
+
+        ++x;
+        expect(image().get() != first);
+    };
+
+    "memory_footprint"_test = [] {
+        auto foo = lazy([] { return 42; });
+        auto bar = lazy(equality{}, [] { return 42; });
+        auto baz = lazy(always_changed{}, [] { return 42; });
+        expect(sizeof(bar) == sizeof(foo));
+        expect(sizeof(baz) == sizeof(foo));
+    };
+};
+
+} // namespace pigro::tests
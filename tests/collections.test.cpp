@@ -0,0 +1,227 @@
+#include "../src/pigro/collections.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite collections_tests = [] {
+    "map"_test = [] {
+        auto xs = lazy_vector{ vector{ 1, 2, 3 } };
+
+        auto counter = 0;
+        auto strings = map(xs, [&](int x) {
+            ++counter;
+            return to_string(x);
+        });
+
+        expect(strings().values() == vector{ "1"s, "2"s, "3"s });
+        expect(counter == 3_i);
+
+        expect(!strings(nullptr).is_changed);
+        expect(counter == 3_i);
+
+        xs.update(1, 20);
+        xs.insert(0, 0);
+        xs.erase(3);
+        expect(strings().values() == vector{ "0"s, "1"s, "20"s });
+        expect(counter == 5_i);
+
+        xs.assign({ 4, 5 });
+        expect(strings().values() == vector{ "4"s, "5"s });
+        expect(counter == 7_i);
+    };
+
+    "map_early_cutoff"_test = [] {
+        auto xs = lazy_vector{ vector{ 1, 2, 3 } };
+        auto parities = map(xs, [](int x) { return x % 2; });
+
+        auto counter = 0;
+        auto copy = lazy([&](const vector_state<int> &parities) {
+            ++counter;
+            return parities.values();
+        },
+          parities);
+
+        parities();
+        copy();
+        expect(counter == 1_i);
+
+        xs.update(0, 3);
+        expect(!parities(nullptr).is_changed);
+        copy();
+        expect(counter == 1_i);
+
+        xs.update(0, 4);
+        expect(parities(nullptr).is_changed);
+        expect(ranges::equal(*parities().changes_since(parities().version() - 1), vector<vector_change<int>>{ { change_kind::update, 0, 0 } }));
+    };
+
+    "filter"_test = [] {
+        auto xs = lazy_vector{ vector{ 1, 2, 3, 4 } };
+
+        auto counter = 0;
+        auto evens = filter(xs, [&](int x) {
+            ++counter;
+            return x % 2 == 0;
+        });
+
+        expect(evens().values() == vector{ 2, 4 });
+        expect(counter == 4_i);
+
+        xs.insert(0, 6);
+        expect(evens().values() == vector{ 6, 2, 4 });
+
+        xs.erase(2);
+        expect(evens().values() == vector{ 6, 4 });
+
+        xs.update(1, 8);
+        xs.update(2, 5);
+        xs.update(3, 10);
+        expect(evens().values() == vector{ 6, 8, 10 });
+        expect(counter == 8_i);
+
+        xs.update(0, 12);
+        expect(evens().values() == vector{ 12, 8, 10 });
+        expect(counter == 9_i);
+    };
+
+    "chaining"_test = [] {
+        auto xs = lazy_vector{ vector<int>(10'000, 1) };
+
+        auto squarings = 0;
+        auto squares = map(filter(xs, [](int x) { return x > 0; }), [&](int x) {
+            ++squarings;
+            return x * x;
+        });
+
+        expect(squares().size() == 10'000_ul);
+        expect(squarings == 10'000_i);
+
+        xs.update(5'000, 3);
+        xs.update(6'000, -1);
+        expect(squares().size() == 9'999_ul);
+        expect(squares()[5'000] == 9_i);
+        expect(squarings == 10'001_i);
+    };
+
+    "reduce"_test = [] {
+        auto xs = lazy_vector{ vector{ 1, 2, 3 } };
+        auto sum = reduce(xs, plus<>{}, 0);
+        expect(sum() == 6_i);
+
+        xs.update(0, 10);
+        expect(sum() == 15_i);
+
+        xs.push_back(4);
+        xs.push_back(5);
+        expect(sum() == 24_i);
+
+        xs.erase(1);
+        xs.insert(0, 100);
+        expect(sum() == 122_i);
+
+        xs.assign({});
+        expect(sum() == 0_i);
+        xs.push_back(7);
+        expect(sum() == 7_i);
+    };
+
+    "reduce_order"_test = [] {
+        auto xs = lazy_vector{ vector{ "a"s, "b"s, "c"s } };
+        auto concatenation = reduce(xs, plus<>{}, ""s);
+        expect(concatenation() == "abc"s);
+
+        xs.insert(1, "x"s);
+        xs.erase(3);
+        xs.update(0, "y"s);
+        expect(concatenation() == "yxb"s);
+    };
+
+    // Stands in for a benchmark: an update of one element recomputes only
+    // the partial results on its path to the root
+    "reduce_updates"_test = [] {
+        constexpr auto size = 1 << 20;
+        auto xs = lazy_vector{ vector<long long>(size, 1) };
+
+        auto applications = 0;
+        auto sum = reduce(xs, [&](long long a, long long b) {
+            ++applications;
+            return a + b;
+        },
+          0ll);
+
+        expect(sum() == size);
+
+        applications = 0;
+        xs.update(12'345, 2);
+        expect(sum() == size + 1);
+        expect(applications == 20_i);
+
+        applications = 0;
+        xs.push_back(1);
+        expect(sum() == size + 2);
+        expect(applications > size);
+
+        applications = 0;
+        xs.update(size, 3);
+        expect(sum() == size + 4);
+        expect(applications == 21_i);
+
+        // Early cutoff when the result is still the same
+        auto counter = 0;
+        auto foo = lazy([&](long long sum) {
+            ++counter;
+            return sum;
+        },
+          sum);
+
+        foo();
+        xs.update(0, 3);
+        xs.update(1, -1);
+        expect(foo() == size + 4);
+        expect(counter == 1_i);
+    };
+
+    "reduce_random"_test = [] {
+        auto generator = mt19937{ 42 };
+        auto values = vector<int>{};
+        auto xs = lazy_vector{ values };
+        auto sum = reduce(xs, plus<>{}, 0);
+
+        for (auto i = 0; i < 1'000; ++i) {
+            const auto value = uniform_int_distribution<>{ -100, 100 }(generator);
+            const auto index = uniform_int_distribution<size_t>{ 0, values.size() }(generator);
+            switch (uniform_int_distribution<>{ 0, 2 }(generator)) {
+            case 0:
+                values.insert(values.begin() + index, value);
+                xs.insert(index, value);
+                break;
+            case 1:
+                if (index == values.size()) break;
+                values.erase(values.begin() + index);
+                xs.erase(index);
+                break;
+            case 2:
+                if (index == values.size()) break;
+                values[index] = value;
+                xs.update(index, value);
+                break;
+            }
+
+            if (i % 7 == 0) expect(sum() == accumulate(values.begin(), values.end(), 0)) << i;
+        }
+    };
+};
+
+} // namespace pigro::tests
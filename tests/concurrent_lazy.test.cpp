@@ -0,0 +1,110 @@
+#include "../src/pigro/concurrent_lazy.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+auto pull_concurrently(int thread_count, auto f) {
+    auto threads = vector<jthread>{};
+    for (auto i = 0; i < thread_count; ++i) {
+        threads.emplace_back(f);
+    }
+}
+
+suite concurrent_lazy_tests = [] {
+    "cached"_test = [] {
+        auto foo_counter = 0;
+        auto foo = concurrent_lazy([&] {
+            ++foo_counter;
+            return 42;
+        });
+
+        expect(foo() == 42_i);
+        expect(foo() == 42_i);
+        expect(foo_counter == 1_i);
+
+        auto bar = foo;
+        expect(bar() == 42_i);
+        expect(foo_counter == 1_i);
+    };
+
+    "dependencies"_test = [] {
+        auto x = atomic<int>{ 1 };
+
+        auto foo = concurrent_lazy([](int x) { return x * 2; }, [&] { return x.load(); });
+        auto bar_counter = 0;
+        auto bar = concurrent_lazy([&](int foo) {
+            ++bar_counter;
+            return foo + 1;
+        },
+          foo);
+
+        expect(bar() == 3_i);
+        expect(bar() == 3_i);
+        expect(bar_counter == 1_i);
+
+        x = 2;
+        expect(bar() == 5_i);
+        expect(bar_counter == 2_i);
+    };
+
+    "void"_test = [] {
+        auto counter = atomic<int>{};
+        auto foo = concurrent_lazy([&] { ++counter; });
+        expect(type<decltype(foo())> == type<void>);
+
+        pull_concurrently(8, [=]() mutable {
+            for (auto i = 0; i < 100; ++i) foo();
+        });
+
+        expect(counter.load() == 1_i);
+    };
+
+    // Stands in for a contention benchmark: whatever the number of threads,
+    // each node is evaluated only once per revision.
+    "contention"_test = [] {
+        for (const auto thread_count : { 1, 2, 4, 8, 16, 32, 64 }) {
+            auto revisions = atomic_revision_counter{};
+            auto x = atomic<int>{ 1 };
+
+            auto foo_counter = atomic<int>{};
+            auto foo = concurrent_lazy(
+              revisions, [&](int x) {
+                  ++foo_counter;
+                  return vector<int>(1'000, x);
+              },
+              [&] { return x.load(); });
+
+            auto mismatches = atomic<int>{};
+            pull_concurrently(thread_count, [&] {
+                for (auto i = 0; i < 1'000; ++i) {
+                    if (foo()[0] != 1) ++mismatches;
+                }
+            });
+
+            expect(foo_counter.load() == 1_i) << thread_count;
+            expect(mismatches.load() == 0_i) << thread_count;
+
+            x = 2;
+            revisions.bump();
+            pull_concurrently(thread_count, [&] {
+                for (auto i = 0; i < 1'000; ++i) {
+                    if (foo()[0] != 2) ++mismatches;
+                }
+            });
+
+            expect(foo_counter.load() == 2_i) << thread_count;
+            expect(mismatches.load() == 0_i) << thread_count;
+        }
+    };
+};
+
+} // namespace pigro::tests
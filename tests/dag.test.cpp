@@ -0,0 +1,156 @@
+#include "../src/pigro/dag.h"
+#include "../src/pigro/source.h"
+#include "../src/pigro/work_stealing_pool.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite dag_tests = [] {
+    "sequential"_test = [] {
+        auto x = 1;
+
+        auto foo_counter = 0;
+        auto foo = dag_lazy([&](int x) {
+            ++foo_counter;
+            return x * 2;
+        },
+          [&] { return x; });
+
+        auto bar = dag_lazy([](int foo) { return foo + 1; }, foo);
+        auto baz = dag_lazy([](int foo) { return foo - 1; }, foo);
+        auto qux = dag_lazy([](int bar, int baz) { return bar + baz; }, bar, baz);
+
+        expect(qux() == 4_i);
+        expect(foo_counter == 1_i);
+
+        x = 2;
+        expect(qux() == 8_i);
+        expect(foo_counter == 2_i);
+    };
+
+    "schedule"_test = [] {
+        auto pool = work_stealing_pool{ 4 };
+        auto x = source{ 1 };
+
+        auto counters = vector<atomic<int>>(4);
+        auto foo = dag_lazy([&](int x) {
+            ++counters[0];
+            return x % 2;
+        },
+          x);
+
+        auto bar = dag_lazy([&](int foo) {
+            ++counters[1];
+            return foo + 1;
+        },
+          foo);
+
+        auto baz = dag_lazy([&](int foo) {
+            ++counters[2];
+            return foo + 2;
+        },
+          foo);
+
+        auto qux = dag_lazy([&](int bar, int baz) {
+            ++counters[3];
+            return bar * baz;
+        },
+          bar,
+          baz);
+
+        expect(schedule(pool, qux, bar) == tuple{ 6, 2 });
+        for (const auto &counter : counters) expect(counter.load() == 1_i);
+
+        // Early cutoff: foo doesn't change
+        x.set(3);
+        expect(schedule(pool, qux) == tuple{ 6 });
+        expect(counters[0].load() == 2_i);
+        expect(counters[1].load() == 1_i);
+        expect(counters[3].load() == 1_i);
+
+        x.set(4);
+        expect(schedule(pool, qux) == tuple{ 2 });
+        expect(counters[0].load() == 3_i);
+        expect(counters[1].load() == 2_i);
+        expect(counters[2].load() == 2_i);
+        expect(counters[3].load() == 2_i);
+
+        // Still usable without the scheduler
+        expect(qux() == 2_i);
+        expect(counters[3].load() == 2_i);
+    };
+
+    // Stands in for a throughput benchmark: random graphs give the same
+    // results no matter the number of threads, while every node is evaluated
+    // at most once per run.
+    "random_dags"_test = [] {
+        constexpr auto node_count = 1'000;
+
+        auto generator = mt19937{ 1729 };
+        auto edges = vector<vector<int>>(node_count);
+        for (auto i = 1; i < node_count; ++i) {
+            auto pick = uniform_int_distribution<>{ 0, i - 1 };
+            edges[i] = { pick(generator), pick(generator) };
+        }
+
+        const auto expected = [&](int input) {
+            auto values = vector<long long>(node_count);
+            values[0] = input;
+            for (auto i = 1; i < node_count; ++i) {
+                values[i] = (values[edges[i][0]] + values[edges[i][1]] + i) % 1'000'003;
+            }
+
+            return values.back();
+        };
+
+        const auto thread_counts = { size_t{ 1 }, size_t{ 2 }, size_t{ 4 }, size_t{ thread::hardware_concurrency() } };
+        for (const auto thread_count : thread_counts) {
+            auto pool = work_stealing_pool{ thread_count };
+            auto input = source{ 1 };
+            auto evaluations = atomic<int>{};
+
+            auto nodes = vector<dag_lazy_function<long long>>{};
+            nodes.push_back(dag_lazy([&](int input) {
+                ++evaluations;
+                return static_cast<long long>(input);
+            },
+              input));
+
+            for (auto i = 1; i < node_count; ++i) {
+                nodes.push_back(dag_lazy([&](long long a, long long b, int i) {
+                    ++evaluations;
+                    return (a + b + i) % 1'000'003;
+                },
+                  nodes[edges[i][0]],
+                  nodes[edges[i][1]],
+                  i));
+            }
+
+            expect(get<0>(schedule(pool, nodes.back())) == expected(1)) << thread_count;
+            expect(evaluations.load() <= node_count) << thread_count;
+
+            evaluations = 0;
+            input.set(2);
+            expect(get<0>(schedule(pool, nodes.back())) == expected(2)) << thread_count;
+            expect(evaluations.load() <= node_count) << thread_count;
+
+            evaluations = 0;
+            expect(nodes.back()() == expected(2)) << thread_count;
+            expect(evaluations.load() == 0_i) << thread_count;
+        }
+    };
+};
+
+} // namespace pigro::tests
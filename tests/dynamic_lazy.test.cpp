@@ -0,0 +1,133 @@
+#include "../src/pigro/dynamic_lazy.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite dynamic_lazy_tests = [] {
+    "branches"_test = [] {
+        auto is_hidden = false;
+        auto hidden_polls = 0;
+        auto icon_polls = 0;
+        auto icon_loads = 0;
+
+        auto icon = lazy([&](int size) {
+            ++icon_loads;
+            return string(size, '#');
+        },
+          [&] {
+              ++icon_polls;
+              return 3;
+          });
+
+        auto render_counter = 0;
+        auto cursor = dynamic_lazy([&](auto hidden, auto icon) {
+            ++render_counter;
+            return hidden() ? ""s : icon();
+        },
+          [&] {
+              ++hidden_polls;
+              return is_hidden;
+          },
+          icon);
+
+        expect(cursor() == "###"s);
+        expect(icon_loads == 1_i);
+        expect(render_counter == 1_i);
+
+        // Re-validates both dependencies, as both were read
+        expect(cursor() == "###"s);
+        expect(icon_polls == 2_i);
+        expect(render_counter == 1_i);
+
+        is_hidden = true;
+        expect(cursor() == ""s);
+        expect(render_counter == 2_i);
+
+        // The icon isn't pulled anymore, while the cursor is hidden
+        icon_polls = 0;
+        hidden_polls = 0;
+        expect(cursor() == ""s);
+        expect(cursor() == ""s);
+        expect(icon_polls == 0_i);
+        expect(hidden_polls == 2_i);
+        expect(render_counter == 2_i);
+
+        is_hidden = false;
+        expect(cursor() == "###"s);
+        expect(icon_polls == 1_i);
+        expect(icon_loads == 1_i);
+        expect(render_counter == 3_i);
+    };
+
+    "validation_order"_test = [] {
+        auto use_x = true;
+        auto x = 1;
+        auto x_polls = 0;
+
+        auto foo = dynamic_lazy([](auto x, auto use_x) { return use_x() ? x() : 0; },
+          [&] {
+              ++x_polls;
+              return x;
+          },
+          [&] { return use_x; });
+
+        expect(foo() == 1_i);
+        x_polls = 0;
+
+        // The condition was read first, so x isn't pulled once it changed
+        use_x = false;
+        expect(foo() == 0_i);
+        expect(x_polls == 0_i);
+    };
+
+    "early_cutoff"_test = [] {
+        auto x = 1;
+        auto foo_counter = 0;
+        auto foo = dynamic_lazy([&](auto x) {
+            ++foo_counter;
+            return x() % 2;
+        },
+          [&] { return x; });
+
+        auto bar_counter = 0;
+        auto bar = lazy([&](int foo) {
+            ++bar_counter;
+            return foo;
+        },
+          foo);
+
+        expect(bar() == 1_i);
+        x = 3;
+        expect(bar() == 1_i);
+        expect(foo_counter == 2_i);
+        expect(bar_counter == 1_i);
+    };
+
+    "values"_test = [] {
+        auto counter = 0;
+        auto foo = dynamic_lazy([&](auto x, auto y) {
+            ++counter;
+            return x() + y();
+        },
+          1,
+          "2"s.size());
+
+        expect(foo() == 2_ul);
+        expect(foo() == 2_ul);
+        expect(counter == 1_i);
+
+        auto bar = dynamic_lazy([&] { ++counter; });
+        bar();
+        bar();
+        expect(counter == 2_i);
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,146 @@
+#include "../src/pigro/effect.h"
+#include "../src/pigro/lazy_vector.h"
+#include "../src/pigro/source.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite effect_tests = [] {
+    "flush"_test = [] {
+        auto scheduler = effect_scheduler{};
+        auto x = source{ 1 };
+
+        auto seen = vector<int>{};
+        const auto e = effect(scheduler, [&](int x) { seen.push_back(x); }, x);
+
+        // Nothing runs until the flush
+        expect(seen.empty());
+        expect(scheduler.flush() == 1_u);
+        expect(seen == vector{ 1 });
+
+        // Idle flushes run nothing
+        expect(scheduler.flush() == 0_u);
+
+        x.set(2);
+        expect(seen == vector{ 1 });
+        expect(scheduler.flush() == 1_u);
+        expect(seen == vector{ 1, 2 });
+    };
+
+    "batching"_test = [] {
+        auto scheduler = effect_scheduler{};
+        auto x = source{ 1 };
+        auto y = source{ 2 };
+
+        auto runs = 0;
+        const auto sum = lazy([](int x, int y) { return x + y; }, x, y);
+        const auto e = effect(scheduler, [&](int) { ++runs; }, sum);
+        scheduler.flush();
+
+        // Scheduled only once, however many sources were written
+        x.set(3);
+        y.set(4);
+        x.set(5);
+        expect(scheduler.pending() == 1_u);
+        expect(scheduler.flush() == 1_u);
+        expect(runs == 2_i);
+    };
+
+    "unaffected"_test = [] {
+        auto scheduler = effect_scheduler{};
+        auto x = source{ 1 };
+        auto y = source{ 1 };
+
+        auto x_runs = 0;
+        auto y_runs = 0;
+        const auto ex = effect(scheduler, [&](int) { ++x_runs; }, x);
+        const auto ey = effect(scheduler, [&](int) { ++y_runs; }, y);
+        scheduler.flush();
+
+        x.set(2);
+        expect(scheduler.flush() == 1_u);
+        expect(x_runs == 2_i);
+        expect(y_runs == 1_i);
+    };
+
+    "early_cutoff"_test = [] {
+        auto scheduler = effect_scheduler{};
+        auto x = source{ 1 };
+
+        auto runs = 0;
+        const auto parity = lazy([](int x) { return x % 2; }, x);
+        const auto e = effect(scheduler, [&](int) { ++runs; }, parity);
+        scheduler.flush();
+
+        // Validated, but not invoked
+        x.set(3);
+        expect(scheduler.flush() == 1_u);
+        expect(runs == 1_i);
+
+        x.set(4);
+        scheduler.flush();
+        expect(runs == 2_i);
+    };
+
+    "order"_test = [] {
+        auto scheduler = effect_scheduler{};
+        auto x = source{ 1 };
+        auto doubled = source{ 0 };
+
+        auto seen = vector<string>{};
+        const auto first = effect(scheduler, [&](int x) {
+            seen.push_back("first");
+            doubled.set(2 * x);
+        },
+          x);
+        const auto second = effect(scheduler, [&](int doubled) { seen.push_back("second " + to_string(doubled)); }, doubled);
+
+        expect(scheduler.flush() == 2_u);
+        expect(seen == vector{ "first"s, "second 2"s });
+
+        // Effects that are notified while flushing run in the same flush
+        seen.clear();
+        x.set(2);
+        expect(scheduler.flush() == 2_u);
+        expect(seen == vector{ "first"s, "second 4"s });
+    };
+
+    "dispose"_test = [] {
+        auto scheduler = effect_scheduler{};
+        auto x = source{ 1 };
+
+        auto runs = 0;
+        auto e = effect(scheduler, [&](int) { ++runs; }, x);
+        scheduler.flush();
+
+        x.set(2);
+        e.dispose();
+        expect(scheduler.pending() == 0_u);
+        expect(scheduler.flush() == 0_u);
+        expect(runs == 1_i);
+    };
+
+    "lazy_vector"_test = [] {
+        auto scheduler = effect_scheduler{};
+        auto xs = lazy_vector<int>{};
+
+        auto sizes = vector<size_t>{};
+        const auto e = effect(scheduler, [&](const auto &xs) { sizes.push_back(xs.size()); }, xs);
+        scheduler.flush();
+
+        xs.push_back(1);
+        xs.push_back(2);
+        scheduler.flush();
+        expect(sizes == vector<size_t>{ 0, 2 });
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,59 @@
+#include "../src/pigro/evaluate.h"
+#include "../src/pigro/shared_lazy.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+#include <tuple>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite evaluate_tests = [] {
+    "values"_test = [] {
+        auto foo = lazy([] { return 42; });
+        auto bar = lazy([](int foo) { return to_string(foo); }, foo);
+
+        auto baz_counter = 0;
+        auto baz = lazy([&] { ++baz_counter; });
+
+        expect(evaluate(foo, bar, baz) == tuple{ 42, "42"s, regular_void{} });
+        expect(evaluate(foo, bar, baz) == tuple{ 42, "42"s, regular_void{} });
+        expect(baz_counter == 1_i);
+
+        expect(evaluate() == tuple{});
+    };
+
+    "shared_ancestors"_test = [] {
+        auto x = 1;
+        auto polls = 0;
+        auto ancestor = shared_lazy([](int x) { return x * 2; }, [&] {
+            ++polls;
+            return x;
+        });
+
+        auto foo = lazy([](int a) { return a + 1; }, ancestor);
+        auto bar = lazy([](int a) { return a + 2; }, ancestor);
+        auto baz = lazy([](int a) { return a + 3; }, ancestor);
+
+        // Separately, every pull validates the ancestor again
+        foo();
+        bar();
+        baz();
+        expect(polls == 3_i);
+
+        polls = 0;
+        expect(evaluate(foo, bar, baz) == tuple{ 3, 4, 5 });
+        expect(polls == 1_i);
+
+        x = 2;
+        polls = 0;
+        expect(evaluate(foo, bar, baz) == tuple{ 5, 6, 7 });
+        expect(polls == 1_i);
+    };
+};
+
+} // namespace pigro::tests
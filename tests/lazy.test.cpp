@@ -3,7 +3,10 @@
 #define BOOST_UT_DISABLE_MODULE
 #include <boost/ut.hpp>
 
+#include <memory>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 using namespace boost::ut;
 using namespace std;
@@ -24,6 +27,42 @@ struct Spy {
     }
 };
 
+struct CopySpy {
+    int *copies;
+    int id = 0;
+
+    CopySpy(int *copies, int id = 0) : copies{ copies }, id{ id } {}
+    CopySpy(const CopySpy &other) : copies{ other.copies }, id{ other.id } { ++*copies; }
+    CopySpy(CopySpy &&) = default;
+    CopySpy &operator=(const CopySpy &other) {
+        copies = other.copies;
+        id = other.id;
+        ++*copies;
+        return *this;
+    }
+    CopySpy &operator=(CopySpy &&) = default;
+
+    auto operator==(const CopySpy &rhs) const { return id == rhs.id; }
+    auto operator!=(const CopySpy &rhs) const { return id != rhs.id; }
+};
+
+struct MoveSpy {
+    int *moves;
+    int id = 0;
+
+    MoveSpy(int *moves, int id = 0) : moves{ moves }, id{ id } {}
+    MoveSpy(MoveSpy &&other) : moves{ other.moves }, id{ other.id } { ++*moves; }
+    MoveSpy &operator=(MoveSpy &&other) {
+        moves = other.moves;
+        id = other.id;
+        ++*moves;
+        return *this;
+    }
+
+    auto operator==(const MoveSpy &rhs) const { return id == rhs.id; }
+    auto operator!=(const MoveSpy &rhs) const { return id != rhs.id; }
+};
+
 suite lazy_tests = [] {
     "cached"_test = [] {
         auto counter = 0;
@@ -119,6 +158,74 @@ suite lazy_tests = [] {
         expect(baz_counter == 4_i);
     };
 
+    "revisions"_test = [] {
+        auto revisions = revision_counter{};
+
+        auto baz_counter = 0;
+        auto baz_result = 0;
+        const auto baz = [&] {
+            ++baz_counter;
+            return baz_result;
+        };
+
+        auto bar_counter = 0;
+        auto bar = lazy([&](auto baz) {
+            ++bar_counter;
+            return baz + 2;
+        },
+          baz);
+
+        auto foo_counter = 0;
+        auto foo = lazy(
+          revisions,
+          [&](auto bar) {
+              ++foo_counter;
+              return bar + 40;
+          },
+          bar);
+
+        expect(foo() == 42_i);
+        expect(foo_counter == 1_i);
+        expect(bar_counter == 1_i);
+        expect(baz_counter == 1_i);
+
+        expect(foo() == 42_i);
+        expect(foo_counter == 1_i);
+        expect(bar_counter == 1_i);
+        expect(baz_counter == 1_i);
+
+        ++baz_result;
+        expect(foo() == 42_i);
+        expect(baz_counter == 1_i);
+
+        revisions.bump();
+        expect(foo() == 43_i);
+        expect(foo_counter == 2_i);
+        expect(bar_counter == 2_i);
+        expect(baz_counter == 2_i);
+
+        revisions.bump();
+        expect(foo() == 43_i);
+        expect(foo_counter == 2_i);
+        expect(bar_counter == 2_i);
+        expect(baz_counter == 3_i);
+    };
+
+    "versions"_test = [] {
+        auto x = 0;
+        auto foo = lazy([](auto x) { return x / 2; }, [&] { return x; });
+
+        expect(foo(nullptr).version == 1_ul);
+        expect(foo(nullptr).version == 1_ul);
+
+        x = 1;
+        expect(foo(nullptr).version == 1_ul);
+
+        x = 2;
+        expect(foo(nullptr).version == 2_ul);
+        expect(foo(nullptr).version == 2_ul);
+    };
+
     "values"_test = [] {
         auto eval_count = 0;
         auto f = lazy([&](auto x) {
@@ -140,6 +247,83 @@ suite lazy_tests = [] {
         expect(type<decltype(f())> == type<void>);
     };
 
+    "references"_test = [] {
+        auto foo = lazy_ref([] { return vector<int>(1'000'000, 42); });
+        expect(type<decltype(foo())> == type<const vector<int> &>);
+
+        const auto &a = foo();
+        const auto &b = foo();
+        expect(&a == &b);
+        expect(a.data() == b.data());
+
+        auto bar = lazy_ref([](const auto &s) { return s + s; }, "pigro"s);
+        expect(&bar() == &bar());
+        expect(bar() == "pigropigro"s);
+
+        auto copies = 0;
+        auto baz = lazy_ref([&] { return CopySpy{ &copies }; });
+        baz();
+        const auto copies_after_first_pull = copies;
+
+        baz();
+        baz();
+        expect(copies == copies_after_first_pull);
+
+        auto qux = lazy_ref([] {});
+        expect(type<decltype(qux())> == type<void>);
+    };
+
+    "argument_copies"_test = [] {
+        auto copies = 0;
+
+        auto id = 0;
+        auto foo = lazy([&](auto id) { return CopySpy{ &copies, id }; }, [&] { return id; });
+
+        auto bar_counter = 0;
+        auto bar = lazy([&](const CopySpy &foo, const CopySpy &baz) {
+            ++bar_counter;
+            return foo.id + baz.id;
+        },
+          foo,
+          CopySpy{ &copies, 1 });
+
+        copies = 0;
+        expect(bar() == 1_i);
+        expect(bar_counter == 1_i);
+
+        ++id;
+        expect(bar() == 2_i);
+        expect(bar_counter == 2_i);
+
+        expect(copies == 0_i);
+    };
+
+    "move_only"_test = [] {
+        auto x = 1;
+        auto foo = lazy_ref([](auto x) { return make_unique<int>(x); }, [&] { return x; });
+        expect(*foo() == 1_i);
+
+        const auto *first = foo().get();
+        expect(foo().get() == first);
+
+        x = 2;
+        expect(*foo() == 2_i);
+
+        auto moves = 0;
+        auto id = 0;
+        auto bar = lazy_ref([&](auto id) { return MoveSpy{ &moves, id }; }, [&] { return id; });
+
+        expect(bar().id == 0_i);
+        expect(moves == 0_i);
+
+        ++id;
+        expect(bar().id == 1_i);
+        expect(moves == 1_i);
+
+        expect(bar().id == 1_i);
+        expect(moves == 1_i);
+    };
+
     "comparisons"_test = [] {
         auto f_comparisons = 0;
         auto f_result = Spy{ 0, &f_comparisons };
@@ -188,45 +372,50 @@ suite lazy_tests = [] {
     };
 
     "memory_footprint"_test = [] {
+        // cached result and its version
+        using cache_t = std::tuple<std::optional<int>, std::size_t>;
+        // last consumed version of a dependency
+        using seen_t = std::size_t;
+
         auto f1 = lazy([] {});
         expect(sizeof(f1) == sizeof(bool));
 
         auto f2 = lazy([] { return 0; });
-        expect(sizeof(f2) == sizeof(std::optional<int>));
+        expect(sizeof(f2) == sizeof(cache_t));
 
         auto x1 = 0;
         auto f3 = lazy([=] { return x1; });
-        expect(sizeof(f3) == sizeof(int) + sizeof(std::optional<int>));
+        expect(sizeof(f3) == sizeof(std::tuple<int, cache_t>));
 
         auto x2 = 0;
         auto f4 = lazy([&] { return x2; });
-        expect(sizeof(f4) == sizeof(int &) + sizeof(std::optional<int>));
+        expect(sizeof(f4) == sizeof(int &) + sizeof(cache_t));
 
         auto x3 = 0;
         auto f5 = lazy([](auto x3) { return x3; }, x3);
-        expect(sizeof(f5) == sizeof(std::optional<int>) + sizeof(int));
+        expect(sizeof(f5) == sizeof(std::tuple<cache_t, int>));
 
         auto x4 = std::integral_constant<int, 0>{};
         auto f6 = lazy([](auto x4) { return x4; }, x4);
-        expect(sizeof(f6) == sizeof(std::optional<int>));
+        expect(sizeof(f6) == sizeof(cache_t) + sizeof(seen_t) + sizeof(cache_t));
 
         auto g1 = [] { return 0; };
         auto f7 = lazy([](auto g1) { return g1; }, g1);
-        expect(sizeof(f7) == sizeof(std::optional<int>) + sizeof(std::optional<int>));
+        expect(sizeof(f7) == sizeof(cache_t) + sizeof(seen_t) + sizeof(cache_t));
 
         auto x5 = 0;
         auto g2 = [=] { return x5; };
         auto f8 = lazy([](auto g2) { return g2; }, g2);
-        expect(sizeof(f8) == sizeof(std::optional<int>) + sizeof(std::optional<int>) + sizeof(int));
+        expect(sizeof(f8) == sizeof(cache_t) + sizeof(seen_t) + sizeof(std::tuple<cache_t, int>));
 
         auto x6 = 0;
         auto g3 = [&] { return x6; };
         auto f9 = lazy([](auto g3) { return g3; }, g3);
-        expect(sizeof(f9) == sizeof(std::optional<int>) + sizeof(std::optional<int>) + sizeof(int &));
+        expect(sizeof(f9) == sizeof(cache_t) + sizeof(seen_t) + sizeof(cache_t) + sizeof(int &));
 
         auto g4 = lazy([] { return 0; });
         auto f10 = lazy([](auto g4) { return g4; }, g4);
-        expect(sizeof(f9) == sizeof(std::optional<int>) + sizeof(std::optional<int>));
+        expect(sizeof(f10) == sizeof(cache_t) + sizeof(seen_t) + sizeof(cache_t));
     };
 };
 
@@ -0,0 +1,204 @@
+#include "../src/pigro/lazy_async.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <coroutine>
+#include <deque>
+#include <string>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+// A minimal event loop: coroutines waiting for I/O are resumed once the loop
+// gets around to it.
+struct event_loop {
+    deque<coroutine_handle<>> pending;
+
+    auto io() {
+        struct awaiter {
+            event_loop &loop;
+
+            auto await_ready() const noexcept { return false; }
+            auto await_suspend(coroutine_handle<> handle) { loop.pending.push_back(handle); }
+            auto await_resume() const noexcept {}
+        };
+
+        return awaiter{ *this };
+    }
+
+    auto run() {
+        while (!pending.empty()) {
+            auto handle = pending.front();
+            pending.pop_front();
+            handle.resume();
+        }
+    }
+};
+
+// Starts running right away, without anyone awaiting it
+struct detached {
+    struct promise_type {
+        auto get_return_object() { return detached{}; }
+        auto initial_suspend() const noexcept { return suspend_never{}; }
+        auto final_suspend() const noexcept { return suspend_never{}; }
+        auto return_void() {}
+        auto unhandled_exception() { terminate(); }
+    };
+};
+
+suite lazy_async_tests = [] {
+    "synchronous"_test = [] {
+        auto x = 1;
+
+        auto foo_counter = 0;
+        auto foo = lazy_async([&](int x) {
+            ++foo_counter;
+            return x * 2;
+        },
+          [&] { return x; });
+
+        expect(sync_wait(foo()) == 2_i);
+        expect(sync_wait(foo()) == 2_i);
+        expect(foo_counter == 1_i);
+
+        x = 2;
+        expect(sync_wait(foo()) == 4_i);
+        expect(foo_counter == 2_i);
+
+        auto bar = lazy_async([](int foo, const string &s) { return s + to_string(foo); }, foo, "pigro"s);
+        expect(sync_wait(bar()) == "pigro4"s);
+
+        auto baz = lazy_async([] {});
+        expect(type<decltype(sync_wait(baz()))> == type<void>);
+    };
+
+    "asynchronous"_test = [] {
+        auto loop = event_loop{};
+
+        auto loads = 0;
+        auto load_image = [&](string filename) -> task<string> {
+            ++loads;
+            co_await loop.io();
+            co_return "image:" + filename;
+        };
+
+        auto arrow = lazy_async(load_image, "arrow.png"s);
+
+        auto cursor_counter = 0;
+        auto cursor = lazy_async([&](const string &arrow) {
+            ++cursor_counter;
+            return "cursor(" + arrow + ")";
+        },
+          arrow);
+
+        auto frames = 0;
+        auto result = string{};
+        // Coroutine lambdas mustn't capture, since the closure is gone by the
+        // time the coroutine resumes
+        [](string &result, auto cursor) -> detached {
+            result = co_await cursor();
+        }(result, cursor);
+
+        // The frame keeps going while the image is loading
+        ++frames;
+        expect(result == ""s);
+        expect(loads == 1_i);
+
+        loop.run();
+        expect(result == "cursor(image:arrow.png)"s);
+        expect(frames == 1_i);
+
+        expect(sync_wait(cursor()) == "cursor(image:arrow.png)"s);
+        expect(loads == 1_i);
+        expect(cursor_counter == 1_i);
+    };
+
+    "single_flight"_test = [] {
+        auto loop = event_loop{};
+
+        auto loads = 0;
+        auto foo = lazy_async([&]() -> task<int> {
+            ++loads;
+            co_await loop.io();
+            co_return 42;
+        });
+
+        auto results = 0;
+        for (auto i = 0; i < 3; ++i) {
+            [](int &results, auto foo) -> detached {
+                results += co_await foo();
+            }(results, foo);
+        }
+
+        loop.run();
+        expect(results == 126_i);
+        expect(loads == 1_i);
+    };
+
+    "early_cutoff"_test = [] {
+        auto loop = event_loop{};
+        auto x = 1;
+
+        auto parity = lazy_async([&](int x) -> task<int> {
+            co_await loop.io();
+            co_return x % 2;
+        },
+          [&] { return x; });
+
+        auto bar_counter = 0;
+        auto bar = lazy_async([&](int parity) {
+            ++bar_counter;
+            return parity;
+        },
+          parity);
+
+        const auto pull = [&] {
+            auto result = -1;
+            [](int &result, auto bar) -> detached {
+                result = co_await bar();
+            }(result, bar);
+
+            loop.run();
+            return result;
+        };
+
+        expect(pull() == 1_i);
+        expect(bar_counter == 1_i);
+
+        x = 3;
+        expect(pull() == 1_i);
+        expect(bar_counter == 1_i);
+
+        x = 4;
+        expect(pull() == 0_i);
+        expect(bar_counter == 2_i);
+    };
+
+    "awaitable_dependencies"_test = [] {
+        auto polls = 0;
+        auto x = 1;
+        auto foo_counter = 0;
+        auto foo = lazy_async([&](int x) {
+            ++foo_counter;
+            return x;
+        },
+          [&]() -> task<int> {
+              ++polls;
+              co_return x;
+          });
+
+        expect(sync_wait(foo()) == 1_i);
+        expect(sync_wait(foo()) == 1_i);
+        expect(polls == 2_i);
+        expect(foo_counter == 1_i);
+
+        x = 2;
+        expect(sync_wait(foo()) == 2_i);
+        expect(foo_counter == 2_i);
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,90 @@
+#include "../src/pigro/lazy_incremental.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <bitset>
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite lazy_incremental_tests = [] {
+    "changes"_test = [] {
+        auto x = 1;
+        auto y = "a"s;
+
+        auto masks = vector<string>{};
+        auto foo = lazy_incremental(
+          vector<string>{},
+          [&](vector<string> &result, const bitset<2> &changes, int x, const string &y) {
+              masks.push_back(changes.to_string());
+              if (changes[0]) result.push_back(to_string(x));
+              if (changes[1]) result.push_back(y);
+          },
+          [&] { return x; },
+          [&] { return y; });
+
+        expect(foo() == vector{ "1"s, "a"s });
+        expect(foo() == vector{ "1"s, "a"s });
+
+        y = "b"s;
+        expect(foo() == vector{ "1"s, "a"s, "b"s });
+
+        x = 2;
+        expect(foo() == vector{ "1"s, "a"s, "b"s, "2"s });
+
+        // Bit 0 is the rightmost one
+        expect(masks == vector{ "11"s, "10"s, "01"s });
+    };
+
+    "early_cutoff"_test = [] {
+        auto x = 1;
+
+        auto updates = 0;
+        auto parity = lazy_incremental(
+          0,
+          [&](int &result, const auto &, int x) {
+              ++updates;
+              const auto previous = result;
+              result = x % 2;
+              return result != previous;
+          },
+          [&] { return x; });
+
+        auto counter = 0;
+        auto foo = lazy([&](int parity) {
+            ++counter;
+            return parity;
+        },
+          parity);
+
+        expect(foo() == 1_i);
+
+        x = 3;
+        expect(foo() == 1_i);
+        expect(updates == 2_i);
+        expect(counter == 1_i);
+
+        x = 4;
+        expect(foo() == 0_i);
+        expect(counter == 2_i);
+    };
+
+    "first_evaluation"_test = [] {
+        auto updates = 0;
+        auto foo = lazy_incremental(42, [&](int &result, const auto &changes) {
+            ++updates;
+            return false;
+        });
+
+        expect(foo(nullptr).is_changed);
+        expect(foo() == 42_i);
+        expect(updates == 1_i);
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,113 @@
+#include "../src/pigro/lazy_vector.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite lazy_vector_tests = [] {
+    "values"_test = [] {
+        auto xs = lazy_vector{ vector{ 1, 2, 3 } };
+        expect(xs().values() == vector{ 1, 2, 3 });
+
+        xs.push_back(4);
+        xs.insert(0, 0);
+        xs.erase(2);
+        xs.update(1, 10);
+        expect(xs().values() == vector{ 0, 10, 3, 4 });
+
+        auto ys = xs;
+        ys.assign({ 42 });
+        expect(xs().values() == vector{ 42 });
+    };
+
+    "changes"_test = [] {
+        auto xs = lazy_vector{ vector{ 1, 2, 3 } };
+        const auto version = xs.version();
+        expect(xs().changes_since(version)->empty());
+
+        xs.update(1, 20);
+        xs.erase(0);
+        xs.push_back(4);
+        expect(xs.version() == version + 3);
+
+        const auto changes = *xs().changes_since(version);
+        expect(ranges::equal(changes, vector<vector_change<int>>{ { change_kind::update, 1, 20 }, { change_kind::erase, 0, 1 }, { change_kind::insert, 2, 4 } }));
+
+        const auto later = *xs().changes_since(version + 2);
+        expect(later.size() == 1_ul);
+
+        // Replacing all values forgets the changes
+        xs.assign({ 1, 2 });
+        expect(!xs().changes_since(version).has_value());
+        expect(xs().changes_since(xs.version())->empty());
+    };
+
+    "compaction"_test = [] {
+        auto xs = lazy_vector{ vector{ 1 } };
+        const auto version = xs.version();
+        for (auto i = 0; i < 1'000; ++i) xs.update(0, i);
+
+        expect(!xs().changes_since(version).has_value());
+        expect(xs().changes_since(xs.version() - 10)->size() == 10_ul);
+    };
+
+    // Stands in for a benchmark: a consumer that patches its result only
+    // touches the changed elements
+    "patching"_test = [] {
+        auto xs = lazy_vector{ vector<int>(1'000'000, 1) };
+
+        auto squarings = 0;
+        auto seen = size_t{};
+        auto squares = vector<int>{};
+        auto foo = lazy([&](const vector_state<int> &xs) {
+            const auto changes = xs.changes_since(seen);
+            if (!changes) {
+                squares.clear();
+                for (const auto x : xs) {
+                    ++squarings;
+                    squares.push_back(x * x);
+                }
+            } else {
+                for (const auto &[kind, index, x] : *changes) {
+                    switch (kind) {
+                    case change_kind::insert: squares.insert(squares.begin() + index, 0); [[fallthrough]];
+                    case change_kind::update:
+                        ++squarings;
+                        squares[index] = x * x;
+                        break;
+                    case change_kind::erase: squares.erase(squares.begin() + index); break;
+                    }
+                }
+            }
+
+            seen = xs.version();
+            return squares.size();
+        },
+          xs);
+
+        expect(foo() == 1'000'000_ul);
+        expect(squarings == 1'000'000_i);
+
+        xs.update(500'000, 3);
+        expect(foo() == 1'000'000_ul);
+        expect(squarings == 1'000'001_i);
+        expect(squares[500'000] == 9_i);
+
+        xs.push_back(2);
+        xs.erase(0);
+        expect(foo() == 1'000'000_ul);
+        expect(squarings == 1'000'002_i);
+        expect(squares.back() == 4_i);
+        expect(squares[499'999] == 9_i);
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,205 @@
+#include "../src/pigro/memoize.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+#include <tuple>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite memoize_tests = [] {
+    "per_key"_test = [] {
+        auto counter = 0;
+        auto square = memoize<int>([&](int x) {
+            ++counter;
+            return x * x;
+        });
+
+        expect(square(2) == 4_i);
+        expect(square(3) == 9_i);
+        expect(square(2) == 4_i);
+        expect(square(3) == 9_i);
+        expect(counter == 2_i);
+    };
+
+    "multiple_arguments"_test = [] {
+        auto counter = 0;
+        auto concat = memoize<string, int>([&](const string &s, int n) {
+            ++counter;
+            auto result = string{};
+            for (auto i = 0; i < n; ++i) result += s;
+            return result;
+        });
+
+        expect(concat("ab"s, 2) == "abab"s);
+        expect(concat("ab"s, 3) == "ababab"s);
+        expect(concat("ab"s, 2) == "abab"s);
+        expect(counter == 2_i);
+    };
+
+    "dependencies"_test = [] {
+        auto scale = 1;
+        auto mesh_counter = 0;
+        auto mesh_for = memoize<int>([&](int id, int scale, const string &name) {
+            ++mesh_counter;
+            return name + to_string(id * scale);
+        },
+          [&] { return scale; },
+          "mesh"s);
+
+        expect(mesh_for(1) == "mesh1"s);
+        expect(mesh_for(2) == "mesh2"s);
+        expect(mesh_counter == 2_i);
+
+        // Every entry notices the change on its own
+        scale = 10;
+        expect(mesh_for(1) == "mesh10"s);
+        expect(mesh_counter == 3_i);
+        expect(mesh_for(1) == "mesh10"s);
+        expect(mesh_counter == 3_i);
+
+        expect(mesh_for(2) == "mesh20"s);
+        expect(mesh_counter == 4_i);
+    };
+
+    "lazy_dependencies"_test = [] {
+        auto x = 1;
+        auto parity = lazy([](int x) { return x % 2; }, [&] { return x; });
+
+        auto counter = 0;
+        auto foo = memoize<int>([&](int key, int parity) {
+            ++counter;
+            return key + parity;
+        },
+          parity);
+
+        expect(foo(10) == 11_i);
+        expect(counter == 1_i);
+
+        x = 3;
+        expect(foo(10) == 11_i);
+        expect(counter == 1_i);
+
+        x = 4;
+        expect(foo(10) == 10_i);
+        expect(counter == 2_i);
+    };
+
+    "void"_test = [] {
+        auto counter = 0;
+        auto foo = memoize<int>([&](int) { ++counter; });
+        expect(type<decltype(foo(1))> == type<void>);
+
+        foo(1);
+        foo(1);
+        foo(2);
+        expect(counter == 2_i);
+    };
+
+    "lru"_test = [] {
+        auto stats = cache_stats{};
+        auto counter = 0;
+        auto square = memoize<int>(lru{ 2, &stats }, [&](int x) {
+            ++counter;
+            return x * x;
+        });
+
+        square(1);
+        square(2);
+        square(1);
+        expect(counter == 2_i);
+
+        // Evicts 2, which was used least recently
+        square(3);
+        expect(stats.evictions == 1_ul);
+
+        expect(square(1) == 1_i);
+        expect(counter == 3_i);
+
+        // Evicted entries are recomputed transparently
+        expect(square(2) == 4_i);
+        expect(counter == 4_i);
+
+        expect(stats.hits == 2_ul);
+        expect(stats.misses == 4_ul);
+        expect(stats.evictions == 2_ul);
+        expect(stats.hit_ratio() == 2.0 / 6.0);
+    };
+
+    "lfu"_test = [] {
+        auto stats = cache_stats{};
+        auto counter = 0;
+        auto square = memoize<int>(lfu{ 2, &stats }, [&](int x) {
+            ++counter;
+            return x * x;
+        });
+
+        square(1);
+        square(1);
+        square(2);
+        square(2);
+        square(2);
+
+        // Evicts 1, which was used least frequently, although 2 was used last
+        square(3);
+        expect(counter == 3_i);
+        expect(square(2) == 4_i);
+        expect(counter == 3_i);
+
+        expect(square(1) == 1_i);
+        expect(counter == 4_i);
+        expect(stats.evictions == 2_ul);
+    };
+
+    "cost_aware"_test = [] {
+        auto stats = cache_stats{};
+        auto counter = 0;
+        auto repeat = memoize<int>(cost_aware{ 10, &string::size, &stats }, [&](int n) {
+            ++counter;
+            return string(n, 'x');
+        });
+
+        repeat(4);
+        repeat(5);
+        expect(stats.evictions == 0_ul);
+
+        // 4 + 5 + 6 exceeds the capacity, so 4 and 5 are evicted
+        repeat(6);
+        expect(stats.evictions == 2_ul);
+
+        expect(repeat(6) == string(6, 'x'));
+        expect(counter == 3_i);
+
+        // A single entry larger than the capacity is kept until the next access
+        expect(repeat(20) == string(20, 'x'));
+        expect(stats.evictions == 3_ul);
+        expect(repeat(20) == string(20, 'x'));
+        expect(counter == 4_i);
+    };
+
+    "eviction_with_dependencies"_test = [] {
+        auto offset = 0;
+        auto counter = 0;
+        auto foo = memoize<int>(lru{ 1 }, [&](int x, int offset) {
+            ++counter;
+            return x + offset;
+        },
+          [&] { return offset; });
+
+        expect(foo(1) == 1_i);
+        expect(foo(2) == 2_i);
+        expect(foo(1) == 1_i);
+        expect(counter == 3_i);
+
+        offset = 10;
+        expect(foo(1) == 11_i);
+        expect(foo(1) == 11_i);
+        expect(counter == 4_i);
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,96 @@
+#include "../src/pigro/parallel_lazy.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <string>
+#include <thread>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite parallel_lazy_tests = [] {
+    "dependencies"_test = [] {
+        auto pool = thread_pool{ 2 };
+
+        auto x = 1;
+        auto foo = lazy([](int x) { return x * 2; }, [&] { return x; });
+
+        auto bar_counter = 0;
+        auto bar = parallel_lazy(
+          pool, [&](int foo, const string &s, int y) {
+              ++bar_counter;
+              return to_string(foo) + s + to_string(y);
+          },
+          foo,
+          "pigro"s,
+          [] { return 42; });
+
+        expect(bar() == "2pigro42"s);
+        expect(bar() == "2pigro42"s);
+        expect(bar_counter == 1_i);
+
+        x = 2;
+        expect(bar() == "4pigro42"s);
+        expect(bar_counter == 2_i);
+
+        auto baz = parallel_lazy([] { return 1729; });
+        expect(baz() == 1729_i);
+
+        auto qux_counter = 0;
+        auto qux = parallel_lazy([&](int) { ++qux_counter; }, foo);
+        expect(type<decltype(qux())> == type<void>);
+        qux();
+        qux();
+        expect(qux_counter == 1_i);
+    };
+
+    // Stands in for a speedup benchmark: the stale siblings are only able to
+    // meet each other when they are pulled at the same time.
+    "parallel"_test = [] {
+        auto pool = thread_pool{ 3 };
+
+        auto arrived = latch{ 3 };
+        auto met = atomic<int>{};
+        const auto load = [&](int id) {
+            arrived.count_down();
+
+            const auto deadline = chrono::steady_clock::now() + 10s;
+            while (!arrived.try_wait() && chrono::steady_clock::now() < deadline) {
+                this_thread::yield();
+            }
+
+            if (arrived.try_wait()) ++met;
+            return id;
+        };
+
+        auto a = lazy(load, 1);
+        auto b = lazy(load, 2);
+        auto c = lazy(load, 3);
+
+        auto sum = parallel_lazy(pool, [](int a, int b, int c) { return a + b + c; }, a, b, c);
+        expect(sum() == 6_i);
+        expect(met.load() == 3_i);
+    };
+
+    "busy_executor"_test = [] {
+        auto pool = thread_pool{ 1 };
+
+        // The single thread of the pool is blocked, so the caller needs to
+        // pull all dependencies itself
+        auto release = latch{ 1 };
+        pool.execute([&] { release.wait(); });
+
+        auto foo = parallel_lazy(pool, [](int a, int b) { return a + b; }, lazy([] { return 1; }), lazy([] { return 2; }));
+        expect(foo() == 3_i);
+
+        release.count_down();
+    };
+};
+
+} // namespace pigro::tests
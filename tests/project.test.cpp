@@ -0,0 +1,118 @@
+#include "../src/pigro/project.h"
+#include "../src/pigro/source.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+#include <tuple>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+struct Settings {
+    int width;
+    int height;
+    string title;
+
+    auto operator==(const Settings &) const -> bool = default;
+};
+
+suite project_tests = [] {
+    "project"_test = [] {
+        auto settings = source{ Settings{ 640, 480, "pigro"s } };
+
+        auto counter = 0;
+        auto foo = lazy([&](int width) {
+            ++counter;
+            return width * 2;
+        },
+          project(settings, &Settings::width));
+
+        expect(foo() == 1280_i);
+        expect(counter == 1_i);
+
+        settings.modify([](Settings &settings) { settings.title = "lazy"s; });
+        settings.modify([](Settings &settings) { settings.height = 600; });
+        expect(foo() == 1280_i);
+        expect(counter == 1_i);
+
+        settings.modify([](Settings &settings) { settings.width = 800; });
+        expect(foo() == 1600_i);
+        expect(counter == 2_i);
+    };
+
+    "callables"_test = [] {
+        auto x = 1;
+        auto parity = project([&] { return x; }, [](int x) { return x % 2; });
+
+        expect(parity() == 1_i);
+        x = 3;
+        expect(!parity(nullptr).is_changed);
+        x = 4;
+        expect(parity(nullptr).is_changed);
+    };
+
+    "split"_test = [] {
+        auto polls = 0;
+        auto point = lazy([&] {
+            ++polls;
+            return tuple{ 1, 2, "pigro"s };
+        });
+
+        auto [x, y, name] = split(point);
+
+        auto x_counter = 0;
+        auto foo = lazy([&](int x, int y) {
+            ++x_counter;
+            return x + y;
+        },
+          x,
+          y);
+
+        expect(foo() == 3_i);
+        expect(name() == "pigro"s);
+
+        // Within a single pull, the shared lazy function is pulled once
+        expect(polls == 1_i);
+        expect(x_counter == 1_i);
+    };
+
+    "split_changes"_test = [] {
+        auto point = source{ pair{ 1, 2 } };
+        auto [x, y] = split(point);
+
+        auto x_counter = 0;
+        auto foo = lazy([&](int x) {
+            ++x_counter;
+            return x;
+        },
+          x);
+
+        auto y_counter = 0;
+        auto bar = lazy([&](int y) {
+            ++y_counter;
+            return y;
+        },
+          y);
+
+        expect(foo() == 1_i);
+        expect(bar() == 2_i);
+
+        point.set({ 1, 3 });
+        expect(foo() == 1_i);
+        expect(bar() == 3_i);
+        expect(x_counter == 1_i);
+        expect(y_counter == 2_i);
+
+        point.set({ 4, 3 });
+        expect(foo() == 4_i);
+        expect(bar() == 3_i);
+        expect(x_counter == 2_i);
+        expect(y_counter == 2_i);
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,87 @@
+#include "../src/pigro/select.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite select_tests = [] {
+    "branches"_test = [] {
+        auto editing = true;
+
+        auto x = 1;
+        auto then_polls = 0;
+        auto then_f = lazy([](int x) { return to_string(x); }, [&] {
+            ++then_polls;
+            return x;
+        });
+
+        auto else_polls = 0;
+        auto else_f = lazy([&] {
+            ++else_polls;
+            return "preview"s;
+        });
+
+        auto mode = select([&] { return editing; }, then_f, else_f);
+
+        expect(mode() == "1"s);
+        expect(mode() == "1"s);
+        expect(then_polls == 2_i);
+        expect(else_polls == 0_i);
+
+        editing = false;
+        expect(mode() == "preview"s);
+        expect(mode() == "preview"s);
+        expect(then_polls == 2_i);
+        expect(else_polls == 1_i);
+
+        // The then branch is validated once it is selected again
+        x = 2;
+        editing = true;
+        expect(mode() == "2"s);
+        expect(then_polls == 3_i);
+    };
+
+    "changes"_test = [] {
+        auto cond = true;
+        auto x = 1;
+        auto y = 1;
+
+        auto foo = select([&] { return cond; }, [&] { return x; }, [&] { return y; });
+
+        expect(foo(nullptr).is_changed);
+        expect(!foo(nullptr).is_changed);
+
+        // Switching to a branch with the same value
+        cond = false;
+        expect(!foo(nullptr).is_changed);
+
+        y = 2;
+        expect(foo(nullptr).is_changed);
+
+        // Changes of the other branch go unnoticed
+        x = 3;
+        expect(!foo(nullptr).is_changed);
+
+        cond = true;
+        const auto result = foo(nullptr);
+        expect(result.is_changed);
+        expect(result.value == 3_i);
+    };
+
+    "values"_test = [] {
+        auto cond = false;
+        auto foo = select([&] { return cond; }, 1, 2.5);
+        expect(foo() == 2.5_d);
+
+        cond = true;
+        expect(foo() == 1.0_d);
+    };
+};
+
+} // namespace pigro::tests
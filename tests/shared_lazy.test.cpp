@@ -0,0 +1,150 @@
+#include "../src/pigro/shared_lazy.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite shared_lazy_tests = [] {
+    "cached"_test = [] {
+        auto counter = 0;
+        auto foo = shared_lazy([&] {
+            ++counter;
+            return 42;
+        });
+
+        expect(counter == 0_i);
+        expect(foo() == 42_i);
+        expect(counter == 1_i);
+
+        expect(foo() == 42_i);
+        expect(counter == 1_i);
+    };
+
+    "copies_share_cache"_test = [] {
+        auto counter = 0;
+        auto foo = shared_lazy([&] {
+            ++counter;
+            return 42;
+        });
+
+        auto bar = foo;
+        expect(bar() == 42_i);
+        expect(foo() == 42_i);
+        expect(counter == 1_i);
+    };
+
+    "diamond"_test = [] {
+        auto filename_counter = 0;
+        auto filename = "arrow.png"s;
+        const auto get_filename = [&] {
+            ++filename_counter;
+            return filename;
+        };
+
+        auto load_counter = 0;
+        const auto load_image = [&](const string &filename) {
+            ++load_counter;
+            return filename.size();
+        };
+
+        auto shared_image = shared_lazy(load_image, get_filename);
+        auto shared_left = lazy([](auto image) { return image + 1; }, shared_image);
+        auto shared_right = lazy([](auto image) { return image + 2; }, shared_image);
+        auto shared_both = lazy([](auto left, auto right) { return left + right; }, shared_left, shared_right);
+
+        expect(shared_both() == 21_u);
+        expect(load_counter == 1_i);
+        expect(filename_counter == 1_i);
+
+        expect(shared_both() == 21_u);
+        expect(load_counter == 1_i);
+        expect(filename_counter == 2_i);
+
+        filename = "crosshair.png"s;
+        expect(shared_both() == 29_u);
+        expect(load_counter == 2_i);
+        expect(filename_counter == 3_i);
+
+        load_counter = 0;
+        filename_counter = 0;
+        filename = "arrow.png"s;
+
+        auto image = lazy(load_image, get_filename);
+        auto left = lazy([](auto image) { return image + 1; }, image);
+        auto right = lazy([](auto image) { return image + 2; }, image);
+        auto both = lazy([](auto left, auto right) { return left + right; }, left, right);
+
+        expect(both() == 21_u);
+        expect(load_counter == 2_i);
+        expect(filename_counter == 2_i);
+
+        filename = "crosshair.png"s;
+        expect(both() == 29_u);
+        expect(load_counter == 4_i);
+        expect(filename_counter == 4_i);
+    };
+
+    "observers"_test = [] {
+        auto x = 0;
+        auto foo = shared_lazy([](auto x) { return x; }, [&] { return x; });
+
+        auto bar_counter = 0;
+        auto bar = lazy([&](auto foo) {
+            ++bar_counter;
+            return foo;
+        },
+          foo);
+
+        auto baz_counter = 0;
+        auto baz = lazy([&](auto foo) {
+            ++baz_counter;
+            return foo;
+        },
+          foo);
+
+        expect(bar() == 0_i);
+        expect(baz() == 0_i);
+
+        ++x;
+        expect(bar() == 1_i);
+        expect(baz() == 1_i);
+        expect(bar_counter == 2_i);
+        expect(baz_counter == 2_i);
+
+        expect(bar() == 1_i);
+        expect(baz() == 1_i);
+        expect(bar_counter == 2_i);
+        expect(baz_counter == 2_i);
+    };
+
+    "revisions"_test = [] {
+        auto revisions = revision_counter{};
+
+        auto x = 0;
+        auto counter = 0;
+        auto foo = shared_lazy(
+          revisions,
+          [&](auto x) {
+              ++counter;
+              return x;
+          },
+          [&] { return x; });
+
+        expect(foo() == 0_i);
+
+        ++x;
+        expect(foo() == 0_i);
+
+        revisions.bump();
+        expect(foo() == 1_i);
+        expect(counter == 2_i);
+    };
+};
+
+} // namespace pigro::tests
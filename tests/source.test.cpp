@@ -0,0 +1,106 @@
+#include "../src/pigro/source.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+struct Input {
+    vector<int> data;
+
+    int *comparisons;
+    auto operator==(const Input &rhs) const {
+        ++*comparisons;
+        return data == rhs.data;
+    }
+    auto operator!=(const Input &rhs) const {
+        return !this->operator==(rhs);
+    }
+};
+
+suite source_tests = [] {
+    "values"_test = [] {
+        auto x = source{ 42 };
+        expect(x() == 42_i);
+
+        x.set(1729);
+        expect(x() == 1729_i);
+
+        x.modify([](int &x) { ++x; });
+        expect(x() == 1730_i);
+
+        auto y = x;
+        y.set(0);
+        expect(x() == 0_i);
+    };
+
+    "versions"_test = [] {
+        auto x = source{ "pigro"s };
+        expect(x(nullptr).is_changed);
+        expect(!x(nullptr).is_changed);
+
+        const auto version = x.version();
+        x.set("pigro"s);
+        expect(x.version() == version + 1);
+        expect(x(nullptr).is_changed);
+        expect(x(nullptr).version == x.version());
+    };
+
+    "dependencies"_test = [] {
+        auto comparisons = 0;
+        auto input = source{ Input{ { 1, 2, 3 }, &comparisons } };
+
+        auto sum_counter = 0;
+        auto sum = lazy([&](const Input &input) {
+            ++sum_counter;
+            auto result = 0;
+            for (const auto x : input.data) result += x;
+            return result;
+        },
+          input);
+
+        expect(sum() == 6_i);
+        expect(sum() == 6_i);
+        expect(sum_counter == 1_i);
+
+        input.modify([](Input &input) { input.data.push_back(4); });
+        expect(sum() == 10_i);
+        expect(sum_counter == 2_i);
+
+        // Writes are changes, even when the value stays the same
+        input.modify([](Input &) {});
+        expect(sum() == 10_i);
+        expect(sum_counter == 3_i);
+
+        expect(comparisons == 0_i);
+    };
+
+    "revisions"_test = [] {
+        auto revisions = revision_counter{};
+        auto x = source{ revisions, 1 };
+
+        auto foo_counter = 0;
+        auto foo = lazy(
+          revisions, [&](int x) {
+              ++foo_counter;
+              return x * 2;
+          },
+          x);
+
+        expect(foo() == 2_i);
+        expect(foo() == 2_i);
+        expect(foo_counter == 1_i);
+
+        x.set(2);
+        expect(foo() == 4_i);
+        expect(foo_counter == 2_i);
+    };
+};
+
+} // namespace pigro::tests
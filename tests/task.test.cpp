@@ -0,0 +1,78 @@
+#include "../src/pigro/task.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+auto answer() -> task<int> {
+    co_return 42;
+}
+
+auto twice(int x) -> task<int> {
+    co_return 2 * co_await answer() + x;
+}
+
+auto fail() -> task<int> {
+    throw runtime_error{ "pigro" };
+    co_return 0;
+}
+
+// Resumes the awaiting coroutine on another thread
+struct resume_elsewhere {
+    jthread &worker;
+
+    auto await_ready() const noexcept { return false; }
+    auto await_suspend(coroutine_handle<> handle) { worker = jthread{ [=] { handle.resume(); } }; }
+    auto await_resume() const noexcept {}
+};
+
+suite task_tests = [] {
+    "lazy_start"_test = [] {
+        auto started = false;
+        auto foo = [&]() -> task<void> {
+            started = true;
+            co_return;
+        };
+
+        auto t = foo();
+        expect(!started);
+
+        sync_wait(move(t));
+        expect(started);
+    };
+
+    "values"_test = [] {
+        expect(sync_wait(answer()) == 42_i);
+        expect(sync_wait(twice(1)) == 85_i);
+
+        auto pointer = sync_wait([]() -> task<unique_ptr<string>> {
+            co_return make_unique<string>("pigro");
+        }());
+        expect(*pointer == "pigro"s);
+    };
+
+    "exceptions"_test = [] {
+        expect(throws<runtime_error>([] { sync_wait(fail()); }));
+    };
+
+    "other_thread"_test = [] {
+        auto worker = jthread{};
+        auto foo = [&]() -> task<thread::id> {
+            co_await resume_elsewhere{ worker };
+            co_return this_thread::get_id();
+        };
+
+        expect(sync_wait(foo()) != this_thread::get_id());
+    };
+};
+
+} // namespace pigro::tests
@@ -0,0 +1,54 @@
+#include "../src/pigro/thread_pool.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <atomic>
+#include <latch>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite thread_pool_tests = [] {
+    "execute"_test = [] {
+        auto pool = thread_pool{ 4 };
+        expect(pool.size() == 4_ul);
+
+        auto counter = atomic<int>{};
+        auto done = latch{ 100 };
+        for (auto i = 0; i < 100; ++i) {
+            pool.execute([&] {
+                ++counter;
+                done.count_down();
+            });
+        }
+
+        done.wait();
+        expect(counter.load() == 100_i);
+    };
+
+    "concurrency"_test = [] {
+        auto pool = thread_pool{ 4 };
+
+        // Would never finish if the tasks weren't running at the same time
+        auto started = latch{ 4 };
+        auto done = latch{ 4 };
+        for (auto i = 0; i < 4; ++i) {
+            pool.execute([&] {
+                started.arrive_and_wait();
+                done.count_down();
+            });
+        }
+
+        done.wait();
+    };
+
+    "at_least_one_thread"_test = [] {
+        auto pool = thread_pool{ 0 };
+        expect(pool.size() == 1_ul);
+    };
+};
+
+} // namespace pigro::tests
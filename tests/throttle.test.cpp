@@ -0,0 +1,131 @@
+#include "../src/pigro/throttle.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <chrono>
+
+using namespace boost::ut;
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace pigro::tests {
+
+struct ManualClock {
+    chrono::steady_clock::time_point time = {};
+
+    auto now() const { return time; }
+};
+
+suite throttle_tests = [] {
+    "throttle"_test = [] {
+        auto clock = ManualClock{};
+        clock.time += 1s;
+
+        auto x = 1;
+        auto polls = 0;
+        auto foo = throttle(clock, [&] {
+            ++polls;
+            return x;
+        },
+          100ms);
+
+        expect(foo() == 1_i);
+        expect(polls == 1_i);
+
+        x = 2;
+        clock.time += 50ms;
+        expect(foo() == 1_i);
+        expect(!foo(nullptr).is_changed);
+        expect(polls == 1_i);
+
+        clock.time += 50ms;
+        expect(foo(nullptr).is_changed);
+        expect(foo() == 2_i);
+        expect(polls == 2_i);
+
+        // Keeps to the cadence of the samples
+        clock.time += 120ms;
+        foo();
+        expect(polls == 3_i);
+        clock.time += 80ms;
+        foo();
+        expect(polls == 4_i);
+
+        // Unless the next sample is overdue
+        clock.time += 1s;
+        foo();
+        clock.time += 50ms;
+        foo();
+        expect(polls == 5_i);
+    };
+
+    "ttl"_test = [] {
+        auto clock = ManualClock{};
+        clock.time += 1s;
+
+        auto x = 1;
+        auto polls = 0;
+        auto foo = ttl(clock, [&] {
+            ++polls;
+            return x;
+        },
+          100ms);
+
+        expect(foo() == 1_i);
+
+        clock.time += 120ms;
+        expect(foo() == 1_i);
+        expect(polls == 2_i);
+
+        // Expires relative to the previous sample
+        clock.time += 80ms;
+        expect(foo() == 1_i);
+        expect(polls == 2_i);
+
+        x = 2;
+        clock.time += 20ms;
+        expect(foo() == 2_i);
+        expect(polls == 3_i);
+    };
+
+    "lazy_dependencies"_test = [] {
+        auto clock = ManualClock{};
+        clock.time += 1s;
+
+        auto x = 1;
+        auto parity = lazy([](int x) { return x % 2; }, [&] { return x; });
+        auto foo = ttl(clock, parity, 1s);
+
+        auto counter = 0;
+        auto bar = lazy([&](int parity) {
+            ++counter;
+            return parity;
+        },
+          foo);
+
+        expect(bar() == 1_i);
+
+        x = 2;
+        expect(bar() == 1_i);
+
+        clock.time += 1s;
+        expect(bar() == 0_i);
+        expect(counter == 2_i);
+
+        x = 4;
+        clock.time += 1s;
+        expect(bar() == 0_i);
+        expect(counter == 2_i);
+    };
+
+    "steady_clock"_test = [] {
+        auto polls = 0;
+        auto foo = throttle([&] { return ++polls; }, 1h);
+
+        expect(foo() == 1_i);
+        expect(foo() == 1_i);
+    };
+};
+
+} // namespace pigro::tests
@@ -4,6 +4,7 @@
 #include <boost/ut.hpp>
 
 #include <functional>
+#include <string>
 
 using namespace boost::ut;
 using namespace std;
@@ -23,6 +24,24 @@ suite tuple_algorithms_tests = [] {
         expect(transform(tuple{ false, true }, inv) == tuple{ true, false });
         expect(transform(tuple{ true, false }, inv) == tuple{ false, true });
         expect(transform(tuple{ true, true }, inv) == tuple{ false, false });
+
+        const auto nested = transform(tuple<tuple<int, int>>{ { 1, 2 } }, identity{});
+        expect(type<decltype(nested)> == type<const tuple<tuple<int, int>>>);
+
+        auto x = 1;
+        expect(transform(tie(x), [](int &x) { return ++x; }) == tuple{ 2 });
+        expect(x == 2_i);
+    };
+
+    "transform_ref"_test = [] {
+        const auto data = tuple{ "pigro"s, 42 };
+        const auto result = transform_ref(data, [](const auto &x) -> const auto & { return x; });
+
+        expect(type<decltype(result)> == type<const tuple<const string &, const int &>>);
+        expect(&get<0>(result) == &get<0>(data));
+        expect(&get<1>(result) == &get<1>(data));
+
+        expect(transform_ref(tuple{ false, true }, logical_not{}) == tuple{ true, false });
     };
 
     "any"_test = [] {
@@ -0,0 +1,86 @@
+#include "../src/pigro/work_stealing_pool.h"
+
+#define BOOST_UT_DISABLE_MODULE
+#include <boost/ut.hpp>
+
+#include <atomic>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace boost::ut;
+using namespace std;
+
+namespace pigro::tests {
+
+suite work_stealing_pool_tests = [] {
+    "execute"_test = [] {
+        auto pool = work_stealing_pool{ 4 };
+        expect(pool.size() == 4_ul);
+
+        auto counter = atomic<int>{};
+        auto done = latch{ 100 };
+        for (auto i = 0; i < 100; ++i) {
+            pool.execute([&] {
+                ++counter;
+                done.count_down();
+            });
+        }
+
+        done.wait();
+        expect(counter.load() == 100_i);
+    };
+
+    "stealing"_test = [] {
+        auto pool = work_stealing_pool{ 4 };
+
+        // All tasks are pushed to the queue of a single thread, which is
+        // blocked until the other threads stole all of them
+        auto mutex = std::mutex{};
+        auto thread_ids = set<thread::id>{};
+        auto stolen = latch{ 3 };
+        auto done = latch{ 1 };
+
+        pool.execute([&] {
+            for (auto i = 0; i < 3; ++i) {
+                pool.execute([&] {
+                    {
+                        const auto lock = scoped_lock{ mutex };
+                        thread_ids.insert(this_thread::get_id());
+                    }
+
+                    stolen.arrive_and_wait();
+                });
+            }
+
+            stolen.wait();
+            done.count_down();
+        });
+
+        done.wait();
+        expect(thread_ids.size() == 3_ul);
+    };
+
+    "nested"_test = [] {
+        auto pool = work_stealing_pool{ 2 };
+
+        auto counter = atomic<int>{};
+        auto done = latch{ 1'000 };
+        for (auto i = 0; i < 10; ++i) {
+            pool.execute([&] {
+                for (auto j = 0; j < 100; ++j) {
+                    pool.execute([&] {
+                        ++counter;
+                        done.count_down();
+                    });
+                }
+            });
+        }
+
+        done.wait();
+        expect(counter.load() == 1'000_i);
+    };
+};
+
+} // namespace pigro::tests